@@ -0,0 +1,239 @@
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Quine_McCluskey_Simplifier.hpp"
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/**
+\file
+\brief	Замеры скорости минимизации на семействах функций
+
+Функции генерируются (с фиксированным зерном, так что от запуска к запуску они одни и те же):
+случайные с разной плотностью единиц, четность, пороговые, перенос сумматора и мультиплексоры.
+Для каждой функции печатается время загрузки и минимизации (и отдельно поиска простых
+импликант и выбора покрытия), количество единиц, простых импликант, импликант
+в результате, пиковая память и количество кубов в каждом раунде склейки. Каждая функция (где есть fork) считается в отдельном
+дочернем процессе, так что пиковая память относится к ней, а не ко всем предыдущим.
+*/
+
+namespace {
+	/**
+	Семейство функций: имя, наименьшее и наибольшее количество переменных, генератор единиц
+	и (если не у любого n) настоящее количество переменных функции для запрошенного n
+	*/
+	struct family {
+		std::string name;
+		size_t min_vars;
+		size_t max_vars;
+		std::function<std::vector<std::uint64_t>(size_t, std::mt19937_64&)> ones;
+		std::function<size_t(size_t)> vars;
+	};
+
+	/**
+	Количество адресных переменных наибольшего мультиплексора не больше чем от n переменных
+	*/
+	auto mux_address(size_t n) -> size_t {
+		size_t k = 1;
+		while (k + 1 + (size_t(1) << (k + 1)) <= n)
+			++k;
+		return k;
+	}
+
+	/**
+	Случайная функция: каждый набор - единица с вероятностью density
+	*/
+	auto random_family(const std::string& name, double density, size_t max_vars) -> family {
+		return { name, 4, max_vars, [density](size_t n, std::mt19937_64& rng) {
+			std::bernoulli_distribution coin(density);
+			std::vector<std::uint64_t> res;
+			for (std::uint64_t x = 0; x < (std::uint64_t(1) << n); ++x)
+				if (coin(rng))
+					res.push_back(x);
+			return res;
+		}, nullptr };
+	}
+
+	/**
+	Все семейства с наибольшим количеством переменных не больше limit
+	*/
+	auto families(size_t limit) -> std::vector<family> {
+		std::vector<family> res;
+		res.push_back(random_family("random10", 0.1, 24));
+		res.push_back(random_family("random30", 0.3, 20));
+		res.push_back(random_family("random50", 0.5, 18));
+		// Четность: все простые импликанты - сами наборы, склеек нет
+		res.push_back({ "parity", 4, 14, [](size_t n, std::mt19937_64&) {
+			std::vector<std::uint64_t> res;
+			for (std::uint64_t x = 0; x < (std::uint64_t(1) << n); ++x)
+				if (bits::popcount(x) % 2 == 1)
+					res.push_back(x);
+			return res;
+		}, nullptr });
+		// Порог: не меньше половины переменных равны единице
+		res.push_back({ "threshold", 4, 16, [](size_t n, std::mt19937_64&) {
+			std::vector<std::uint64_t> res;
+			for (std::uint64_t x = 0; x < (std::uint64_t(1) << n); ++x)
+				if (2 * bits::popcount(x) >= n)
+					res.push_back(x);
+			return res;
+		}, nullptr });
+		// Перенос из старшего разряда сумматора двух n / 2-битных чисел
+		res.push_back({ "adder", 4, 24, [](size_t n, std::mt19937_64&) {
+			const auto half = n / 2;
+			std::vector<std::uint64_t> res;
+			for (std::uint64_t x = 0; x < (std::uint64_t(1) << (2 * half)); ++x)
+				if (((x & ((std::uint64_t(1) << half) - 1)) + (x >> half)) >> half)
+					res.push_back(x);
+			return res;
+		}, nullptr });
+		// Мультиплексор: k адресных переменных и 2^k переменных данных,
+		// так что переменных k + 2^k (6, 11, 20), а не n
+		res.push_back({ "mux", 6, 20, [](size_t n, std::mt19937_64&) {
+			const auto k = mux_address(n);
+			std::vector<std::uint64_t> res;
+			for (std::uint64_t x = 0; x < (std::uint64_t(1) << (k + (size_t(1) << k))); ++x)
+				if ((x >> (k + (x & ((std::uint64_t(1) << k) - 1)))) & 1)
+					res.push_back(x);
+			return res;
+		}, [](size_t n) {
+			const auto k = mux_address(n);
+			return k + (size_t(1) << k);
+		} });
+		for (auto& f : res)
+			f.max_vars = std::min(f.max_vars, limit);
+		return res;
+	}
+
+	/**
+	Пиковая память процесса в килобайтах (0, если узнать нельзя)
+	*/
+	auto peak_kb() -> long {
+#if !defined(_WIN32)
+		rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) == 0)
+			return usage.ru_maxrss;
+#endif
+		return 0;
+	}
+
+	auto ms_since(std::chrono::steady_clock::time_point start) -> double {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	/**
+	Минимизирует функцию семейства f от n переменных и печатает строку таблицы
+	*/
+	auto run(const family& f, size_t n, size_t vars, std::uint64_t seed, simplify_options options, size_t threads) -> void {
+		simplify_stats stats;
+		options.stats = &stats;
+		std::mt19937_64 rng(seed * 1000003 + n);
+		const auto ones = f.ones(n, rng);
+
+		Quine_McCluskey_Simplifier QMS;
+		QMS.set_threads(threads);
+		auto start = std::chrono::steady_clock::now();
+		QMS.init(ones);
+		const auto load = ms_since(start);
+		start = std::chrono::steady_clock::now();
+		QMS.simplify(options);
+		const auto simplify = ms_since(start);
+
+		std::cout << std::left << std::setw(12) << f.name << std::right
+			<< std::setw(6) << vars << std::setw(10) << ones.size()
+			<< std::fixed << std::setprecision(2)
+			<< std::setw(12) << load << std::setw(14) << simplify
+			<< std::setw(12) << stats.implicants_ms
+			<< std::setw(12) << stats.table_ms + stats.core_ms + stats.reduce_ms + stats.cover_ms
+			<< std::setw(10) << stats.primes << std::setw(8) << QMS.mdnf().size() << std::setw(12) << peak_kb()
+			<< std::setw(8) << stats.rounds << "  ";
+		// Количество кубов в каждом раунде склейки, через косую черту
+		for (size_t i = 0; i < stats.cubes_per_round.size(); ++i)
+			std::cout << (i ? "/" : "") << stats.cubes_per_round[i];
+		std::cout << std::endl;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	size_t max_vars = 12;
+	size_t step = 2;
+	std::uint64_t seed = 1;
+	std::string only;
+	simplify_options options;
+	size_t threads = 1;
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg(argv[i]);
+		const auto has_value = i + 1 < argc;
+		if (arg == "-h" || arg == "-help") {
+			std::cout << "usage: QMS_bench [-max_vars n] [-step n] [-seed n] [-family name]\n\
+\t[-engine qm|implicit|espresso] [-cover greedy|exact] [-threads n]\n\
+families: random10 random30 random50 parity threshold adder mux\n";
+			return 0;
+		}
+		else if (arg == "-max_vars" && has_value)
+			max_vars = std::stoul(argv[++i]);
+		else if (arg == "-step" && has_value)
+			step = std::max<size_t>(std::stoul(argv[++i]), 1);
+		else if (arg == "-seed" && has_value)
+			seed = std::stoull(argv[++i]);
+		else if (arg == "-family" && has_value)
+			only = argv[++i];
+		else if (arg == "-engine" && has_value) {
+			const std::string engine(argv[++i]);
+			options.engine = engine == "espresso" ? e_espresso : engine == "implicit" ? e_implicit : e_quine_mccluskey;
+		}
+		else if (arg == "-cover" && has_value)
+			options.cover = std::string(argv[++i]) == "exact" ? c_exact : c_greedy;
+		else if (arg == "-threads" && has_value)
+			threads = std::stoul(argv[++i]);
+		else {
+			std::cout << "Unexpected usage. Try -h or -help to see help.\n";
+			return 1;
+		}
+	}
+
+	std::cout << std::left << std::setw(12) << "family" << std::right
+		<< std::setw(6) << "vars" << std::setw(10) << "ones"
+		<< std::setw(12) << "load_ms" << std::setw(14) << "simplify_ms"
+		<< std::setw(12) << "primes_ms" << std::setw(12) << "cover_ms"
+		<< std::setw(10) << "primes" << std::setw(8) << "terms" << std::setw(12) << "peak_kb"
+		<< std::setw(8) << "rounds" << "  " << "cubes_per_round" << "\n";
+	for (const auto& f : families(max_vars)) {
+		if (!only.empty() && f.name != only)
+			continue;
+		size_t last = 0;
+		for (auto n = f.min_vars; n <= f.max_vars; n += step) {
+			// Функция, которая уже была напечатана, не повторяется
+			const auto vars = f.vars ? f.vars(n) : n;
+			if (vars == last)
+				continue;
+			last = vars;
+#if !defined(_WIN32)
+			// Функция считается в дочернем процессе: его пиковая память - память этой функции
+			std::cout.flush();
+			const auto pid = fork();
+			if (pid == 0) {
+				run(f, n, vars, seed, options, threads);
+				std::cout.flush();
+				_exit(0);
+			}
+			if (pid > 0) {
+				int status = 0;
+				waitpid(pid, &status, 0);
+				continue;
+			}
+#endif
+			run(f, n, vars, seed, options, threads);
+		}
+	}
+	return 0;
+}
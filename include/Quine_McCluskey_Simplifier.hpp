@@ -1,13 +1,29 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <chrono>
+#include <exception>
 #include <iostream>
+#include <iterator>
 #include <fstream>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
 #include <sstream>
 #include <tuple>
-#include <regex>
+#include <thread>
+#include "bdd.hpp"
+#include "cover_matrix.hpp"
+#include "cover_solver.hpp"
+#include "cube.hpp"
+#include "cube_set.hpp"
+#include "espresso.hpp"
+#include "mapped_file.hpp"
+#include "set_tokenizer.hpp"
+#include "vector_scan.hpp"
+#include "zdd.hpp"
 
 
 /**
@@ -18,12 +34,164 @@
 классов, используемых в демонстрационной программе
 */
 
+/**
+\brief	Статистика минимизации.
+
+\detail Заполняется Quine_McCluskey_Simplifier::simplify, если в simplify_options::stats
+передан указатель на нее. Времена - в миллисекундах
+*/
+struct simplify_stats {
+	/**
+	Время поиска простых импликант (или всей эвристики Espresso)
+	*/
+	double implicants_ms = 0;
+	/**
+	Время построения таблиц покрытия
+	*/
+	double table_ms = 0;
+	/**
+	Время выделения ядра (для e_implicit - поиск существенных импликант по диаграммам)
+	*/
+	double core_ms = 0;
+	/**
+	Время сокращения таблицы (существенные столбцы, доминирование)
+	*/
+	double reduce_ms = 0;
+	/**
+	Время выбора покрытия (жадного или точного)
+	*/
+	double cover_ms = 0;
+	/**
+	Общее время simplify
+	*/
+	double total_ms = 0;
+	/**
+	Количество раундов склейки и количество кубов в начале каждого раунда
+	(для e_implicit склейки нет: 0 и пусто, как и comparisons)
+	*/
+	size_t rounds = 0;
+	std::vector<size_t> cubes_per_round;
+	/**
+	Количество проверенных пар кубов (проверок соседства)
+	*/
+	size_t comparisons = 0;
+	/**
+	Количество простых импликант и из них - вошедших в ядро. Для e_implicit primes
+	считается по ZDD, а в таблицу покрытия попадают только импликанты циклического ядра
+	*/
+	size_t primes = 0;
+	size_t essential = 0;
+	/**
+	Размер таблицы после выделения ядра: строки (непокрытые наборы) и столбцы (импликанты)
+	*/
+	size_t table_rows = 0;
+	size_t table_cols = 0;
+	/**
+	Размер циклического ядра (после сокращения таблицы)
+	*/
+	size_t core_rows = 0;
+	size_t core_cols = 0;
+	/**
+	Количество выбранных импликант: существенных при сокращении и при выборе покрытия
+	*/
+	size_t reduce_picks = 0;
+	size_t cover_picks = 0;
+	/**
+	Количество узлов перебора точного выбора покрытия
+	*/
+	size_t nodes = 0;
+	/**
+	Количество импликант в результате
+	*/
+	size_t terms = 0;
+
+	auto print(std::ostream& os = std::cout) const -> void;
+};
+
+class result_cache;
+
+/**
+\brief	Параметры минимизации.
+
+\detail Передаются в Quine_McCluskey_Simplifier::simplify
+*/
+struct simplify_options {
+	/**
+	Способ минимизации. Для e_espresso параметры выбора покрытия ниже не используются
+	*/
+	engine_type engine = e_quine_mccluskey;
+	/**
+	Способ выбора покрытия после выделения ядра
+	*/
+	cover_type cover = c_greedy;
+	/**
+	Сокращать ли таблицу покрытия (существенные столбцы, доминирование строк и столбцов)
+	перед выбором покрытия. Проход сокращения идет по спискам таблицы, сравнивая только
+	строки (столбцы) с общими элементами, так что стоит порядка самой таблицы
+	*/
+	bool reduce = true;
+	/**
+	Максимальное количество узлов перебора для точного выбора покрытия
+	*/
+	size_t node_limit = 1000000;
+	/**
+	Максимальное время точного выбора покрытия
+	*/
+	std::chrono::milliseconds time_limit = std::chrono::milliseconds(1000);
+	/**
+	Для e_implicit: наибольшее количество импликант, которые выписываются в таблицу покрытия
+	(не вошедшие в ядро и покрывающие непокрытые ядром единицы)
+	*/
+	size_t prime_limit = 1000000;
+	/**
+	Куда записать статистику (nullptr - не собирать)
+	*/
+	simplify_stats* stats = nullptr;
+	/**
+	Кэш результатов (nullptr - не использовать): если функция с такими же параметрами
+	уже минимизировалась, результат берется из него
+	*/
+	result_cache* cache = nullptr;
+};
+
+/**
+Результат минимизации одной функции
+*/
+struct simplify_result {
+	/**
+	Количество переменных функции
+	*/
+	size_t vars = 0;
+	/**
+	Импликанты МДНФ в том же порядке, в каком их печатает print_mdnf
+	*/
+	std::vector<cube> mdnf;
+	/**
+	Доказана ли минимальность (см. Quine_McCluskey_Simplifier::is_minimal)
+	*/
+	bool minimal = false;
+};
+
+/**
+Булева функция, заданная номерами наборов: на которых она равна единице и на которых
+ее значение не определено (как у Quine_McCluskey_Simplifier::init). Используется
+для пакетной (batch_simplifier) и многовыходной (multi_output_simplifier) минимизации
+*/
+struct boolean_function {
+	std::vector<std::uint64_t> ones;
+	std::vector<std::uint64_t> dont_cares;
+};
+
 /**
 \brief	Метод Квайна-МакКласки.
 
 \detail Данный класс позволяет минимизировать булеву функцию,
 заданную в виде наборов, на которых функция принимает значение 1,
 по методу Квайна-МакКласки.
+Наборы и импликанты хранятся как cube, так что переменных не больше 64: номер набора -
+64-битное число. Исключение - номера наборов из файла или потока (init с sets = true):
+номера до 128 бит хранятся как wide_cube, и такие функции минимизируются только
+эвристикой Espresso (см. simplify_wide); для номера больше 128 бит init выбрасывает исключение.
 
 Данные считываются из заданного входного файла,
 записываются в заданный выходной.
@@ -32,27 +200,56 @@
 */
 class Quine_McCluskey_Simplifier {
 	/**
-	Хранит разбиение наборов на группы по весу \n
+	Хранит разбиение наборов на группы по весу. Внутри группы наборы отсортированы
+	по маске, так что наборы с одинаковыми позициями '-' идут подряд (корзины) \n
 	Так как это одна их двух наиболее сложных структур в этой реализации, то 
 	сложность по памяти будет \f$ O(n) \f$, где \f$ n \f$ - количество единиц функции
 	*/
-	std::vector<std::vector<std::pair<std::string, bool>>> groups_;
+	std::vector<std::vector<std::pair<cube, bool>>> groups_;
 	/**
 	Все простые импликанты функции
 	*/
-	std::vector<std::string> implicants_;
+	std::vector<cube> implicants_;
 	/**
 	Входные данные - наборы, на которых функция принимает значение 1
 	*/
-	std::vector<std::string> input_sets_;
+	std::vector<cube> input_sets_;
+	/**
+	Наборы, на которых значение функции не определено (don't care). Используются
+	при склейке, но покрывать их не нужно
+	*/
+	std::vector<cube> dont_cares_;
 	/**
 	Ядро функции
 	*/
-	std::vector<std::string> prime_;
+	std::vector<cube> prime_;
 	/**
 	Полученная минимальная дизъюнктивная форма (МДНФ)
 	*/
-	std::set<std::string> mdnf_;
+	std::set<cube> mdnf_;
+	/**
+	Единицы, неопределенные наборы и МДНФ функции больше чем от 64 переменных
+	(пустые для остальных функций)
+	*/
+	std::vector<wide_cube> wide_ones_;
+	std::vector<wide_cube> wide_dont_cares_;
+	std::set<wide_cube> wide_mdnf_;
+	/**
+	Количество переменных функции
+	*/
+	size_t vars_ = 0;
+	/**
+	Количество потоков, которыми выполняется склейка соседних групп
+	*/
+	size_t threads_ = 1;
+	/**
+	Доказана ли минимальность результата (см. is_minimal)
+	*/
+	bool minimal_ = false;
+	/**
+	Заданы ли единицы кубами (init_cubes), а не наборами
+	*/
+	bool cube_input_ = false;
 	/**
 	Таблица покрытия простыми импликантами \n
 	table представляет собой таблицу, которая хранит наборы и импликанты в виде:\n
@@ -67,33 +264,49 @@ class Quine_McCluskey_Simplifier {
 	где 1 в ячейке ставится,
 	если импликант j покрывает единицу функции на наборе i,
 	0 - иначе \n
-	Это вторая наиболее сложная структура, которая занимает \f$ O(n \cdot m) \f$ памяти, где \f$ n \f$ - количество единиц функции,
-	\f$ m \f$ - количество импликант функции
+	Это вторая наиболее сложная структура, которая занимает \f$ O(n \cdot m) \f$ бит памяти, где \f$ n \f$ - количество единиц функции,
+	\f$ m \f$ - количество импликант функции. Хранится по биту на ячейку (см. cover_matrix)
 	*/
-	std::vector<std::pair<std::vector<size_t>, bool>> table_;
+	cover_matrix table_;
 
-	auto align(const size_t, const size_t) -> void;
+	/**
+	Больше ли у функции переменных, чем помещается в cube
+	*/
+	auto wide() const -> bool { return vars_ > cube::max_vars; }
+	auto add_minterms(const std::vector<std::uint64_t>&, const std::vector<std::uint64_t>&) -> void;
+	auto clear_groups() -> void;
+	auto clear_wide() -> void;
+	auto combine(const size_t, std::vector<cube>&, cube_set&, size_t&) -> bool;
+	auto combine_round(std::vector<cube>&, size_t&) -> bool;
 	auto create_groups(decltype(input_sets_)&) -> void;
 	auto create_table(const decltype(input_sets_)&, const decltype(input_sets_)&) -> void;
-	auto find_max_cover_ind(const std::vector<size_t>&) const->size_t;
-	auto get_func_core()->std::vector<std::string>;
-	auto get_implicants() -> void;
-	auto get_weight(const std::string&) const->size_t;
+	auto get_func_core()->std::vector<cube>;
+	auto get_implicants(simplify_stats*) -> void;
+	auto get_implicants_implicit(const size_t, simplify_stats&) -> std::vector<cube>;
 	auto impl_to_formula(const std::string&) const->std::string;
-	auto in_vect(const std::vector<std::string>&, const std::string&) const -> bool;
-	auto in_vect(const std::vector<std::pair<std::string, size_t>>&, const std::string&) const -> bool;
-	auto is_cover(const std::string&, const std::string&) const -> bool;
-	auto is_neighbors(const std::string&, const std::string&) const -> bool;
-	auto is_prime(const std::vector<size_t>&) const -> bool;
+	auto load_sets(const char*, const char*) -> void;
+	auto load_wide_sets(const char*, const char*) -> void;
+	auto mdnf_strings() const->std::vector<std::string>;
 	auto num_of_vars() const->size_t;
-	auto string_base10_to_base2(std::string) const->std::string;
+	auto parse_sets(const char*, const char*, std::vector<std::uint64_t>&, std::vector<std::uint64_t>&) const -> void;
+	auto parse_vector(const char*, const char*, std::vector<std::uint64_t>&, std::vector<std::uint64_t>&) const -> void;
+	auto prepare(const size_t vars = 0) -> void;
+	auto simplify_wide(const simplify_options&) -> void;
 public:
 	Quine_McCluskey_Simplifier() {};
 	Quine_McCluskey_Simplifier(const std::string & file_name);
 	Quine_McCluskey_Simplifier(std::istream & ss);
 
 	auto init(std::istream&, bool) -> void;
-	auto simplify() -> void;
+	auto init(const std::string&, bool) -> void;
+	auto init(const std::vector<std::uint64_t>&, const std::vector<std::uint64_t>& dont_cares = std::vector<std::uint64_t>(), const size_t vars = 0) -> void;
+	auto init_cubes(const std::vector<cube>&, const size_t) -> void;
+	auto set_threads(const size_t) -> void;
+	auto simplify(const simplify_options& options = simplify_options()) -> void;
+	auto is_minimal() const -> bool;
+	auto mdnf() const -> const std::set<cube>&;
+	auto wide_mdnf() const -> const std::set<wide_cube>&;
+	auto variables() const -> size_t;
 	auto print_formula(std::ostream&) const -> void;
 	auto print_mdnf(std::ostream& os = std::cout) const -> void;
 	auto print_mdnf(const std::string&) const -> void;
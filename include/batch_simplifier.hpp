@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Quine_McCluskey_Simplifier.hpp"
+
+/**
+\file
+\brief	Заголовочный файл с описанием пакетной минимизации
+
+Когда функций тысячи и каждая небольшая, выгоднее не распараллеливать склейку внутри
+одной функции, а раздать сами функции потокам. У каждого потока свой объект
+Quine_McCluskey_Simplifier, который переиспользуется от функции к функции.
+*/
+
+/**
+\brief	Пакетная минимизация.
+
+\detail Функции раздаются потокам по одной (через общий счетчик), результаты
+записываются на место функции, так что порядок совпадает с входным и не зависит
+от количества потоков. Рабочие объекты (по одному на поток) сохраняются между
+вызовами simplify, поэтому память под наборы и группы выделяется заново редко.
+*/
+class batch_simplifier {
+	/**
+	Рабочие объекты потоков
+	*/
+	std::vector<Quine_McCluskey_Simplifier> workspaces_;
+public:
+	explicit batch_simplifier(const size_t threads = 0);
+
+	auto threads() const -> size_t { return workspaces_.size(); }
+	auto simplify(const std::vector<boolean_function>&, const simplify_options& options = simplify_options()) -> std::vector<simplify_result>;
+};
@@ -0,0 +1,120 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "cube.hpp"
+
+/**
+\file
+\brief	Заголовочный файл с описанием упорядоченных двоичных диаграмм решений (ROBDD)
+
+Функция хранится как граф, а не как таблица истинности, так что формулы с 30 и более
+переменными, у которых диаграмма небольшая, обрабатываются без перебора всех наборов.
+Переменная с номером k соответствует биту k номера набора (и куба), переменная 0 - верхняя.
+*/
+
+/**
+\brief	Менеджер сокращенных упорядоченных диаграмм решений.
+
+\detail Все узлы лежат в одном векторе, функция задается номером узла. Одинаковые узлы
+не создаются дважды (таблица уникальности unique_), поэтому равные функции имеют равные
+номера. Все операции сводятся к ITE (if-then-else), результаты которой запоминаются
+в computed_. Узлы не удаляются сами: долгие серии операций освобождают память
+сборкой мусора collect. Переменных не больше 64 (кубы - cube).
+*/
+class bdd {
+	/**
+	Узел: переменная и потомки при ее значениях 0 (low) и 1 (high)
+	*/
+	struct node {
+		size_t var;
+		size_t low;
+		size_t high;
+	};
+
+	/**
+	Ключ таблиц unique_ и computed_
+	*/
+	struct triple {
+		size_t a;
+		size_t b;
+		size_t c;
+
+		auto operator==(const triple& o) const -> bool {
+			return a == o.a && b == o.b && c == o.c;
+		}
+	};
+
+	struct triple_hash {
+		auto operator()(const triple& t) const -> size_t {
+			auto h = static_cast<std::uint64_t>(t.a) * 0x9E3779B97F4A7C15ULL;
+			h ^= static_cast<std::uint64_t>(t.b) * 0xC2B2AE3D27D4EB4FULL + (h >> 29);
+			h ^= static_cast<std::uint64_t>(t.c) * 0x165667B19E3779F9ULL + (h >> 32);
+			return static_cast<size_t>(h);
+		}
+	};
+
+	/**
+	Количество переменных
+	*/
+	size_t vars_;
+	/**
+	Все узлы, nodes_[0] и nodes_[1] - константы
+	*/
+	std::vector<node> nodes_;
+	/**
+	Таблица уникальности: (переменная, low, high) -> узел
+	*/
+	std::unordered_map<triple, size_t, triple_hash> unique_;
+	/**
+	Кэш ITE: (f, g, h) -> результат
+	*/
+	std::unordered_map<triple, size_t, triple_hash> computed_;
+
+	auto make(const size_t, const size_t, const size_t) -> size_t;
+	auto cofactor(const size_t, const size_t, const bool) const -> size_t;
+	auto paths(const size_t, std::uint64_t, std::uint64_t, std::vector<std::uint64_t>&) const -> void;
+	auto build(const std::vector<cube>&, const size_t) -> size_t;
+	auto cofactor(const size_t, const cube&, std::unordered_map<size_t, size_t>&) -> size_t;
+	auto isop(const size_t, const size_t, const std::uint64_t, const std::uint64_t, std::vector<cube>&) -> size_t;
+public:
+	/**
+	Константы 0 и 1
+	*/
+	enum : size_t { zero = 0, one = 1 };
+
+	explicit bdd(const size_t vars);
+
+	auto variable(const size_t) -> size_t;
+	auto ite(const size_t, const size_t, const size_t) -> size_t;
+	auto negate(const size_t) -> size_t;
+	auto conj(const size_t, const size_t) -> size_t;
+	auto disj(const size_t, const size_t) -> size_t;
+	auto from_cubes(const std::vector<cube>&) -> size_t;
+	auto collect(std::vector<size_t>&) -> void;
+
+	auto count(const size_t) const -> double;
+	auto value(const size_t, const std::uint64_t) const -> bool;
+	auto cofactor(const size_t, const cube&) -> size_t;
+	auto minterms(const size_t) const -> std::vector<std::uint64_t>;
+	auto prime_cover(const size_t, const size_t dont_cares = zero) -> std::vector<cube>;
+
+	/**
+	Количество переменных
+	*/
+	auto variables() const -> size_t { return vars_; }
+	/**
+	Верхняя переменная узла f (у констант - больше любой переменной)
+	*/
+	auto var(const size_t f) const -> size_t { return nodes_[f].var; }
+	/**
+	Потомки узла f при значениях верхней переменной 0 и 1
+	*/
+	auto low(const size_t f) const -> size_t { return nodes_[f].low; }
+	auto high(const size_t f) const -> size_t { return nodes_[f].high; }
+	/**
+	Количество узлов (вместе с константами)
+	*/
+	auto size() const -> size_t { return nodes_.size(); }
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "cube.hpp"
+
+/**
+\file
+\brief	Заголовочный файл с описанием битовой таблицы покрытия
+
+Таблица покрытия хранится по одному биту на ячейку сразу в двух видах - по строкам
+и по столбцам, так что количество единиц в строке или столбце считается
+подсчетом единиц в словах, а обход столбца не требует прохода по всем строкам.
+*/
+
+/**
+\brief	Битовая таблица покрытия.
+
+\detail Строки - наборы (единицы функции), столбцы - импликанты. В ячейке (i, j)
+стоит 1, если импликант j покрывает набор i. Для 50000 наборов и 10000 импликант
+каждое из двух представлений занимает около 60 МБ.
+*/
+class cover_matrix {
+	/**
+	Количество строк
+	*/
+	size_t rows_ = 0;
+	/**
+	Количество столбцов
+	*/
+	size_t cols_ = 0;
+	/**
+	Количество слов в одной строке
+	*/
+	size_t row_words_ = 0;
+	/**
+	Количество слов в одном столбце
+	*/
+	size_t col_words_ = 0;
+	/**
+	Таблица по строкам: rows * row_words слов
+	*/
+	std::vector<std::uint64_t> by_rows_;
+	/**
+	Таблица по столбцам: cols * col_words слов
+	*/
+	std::vector<std::uint64_t> by_cols_;
+public:
+	cover_matrix() {};
+	cover_matrix(const size_t rows, const size_t cols);
+
+	auto set(const size_t, const size_t) -> void;
+	auto get(const size_t, const size_t) const -> bool;
+	auto row_count(const size_t) const -> size_t;
+	auto col_count(const size_t) const -> size_t;
+	auto first_in_row(const size_t) const -> size_t;
+	auto clear() -> void;
+
+	auto rows() const -> size_t { return rows_; }
+	auto cols() const -> size_t { return cols_; }
+	auto row_words() const -> size_t { return row_words_; }
+	auto col_words() const -> size_t { return col_words_; }
+	auto row(const size_t r) const -> const std::uint64_t* { return by_rows_.data() + r * row_words_; }
+	auto col(const size_t c) const -> const std::uint64_t* { return by_cols_.data() + c * col_words_; }
+
+	/**
+	Вызывает f(j) для каждого столбца j, в котором в строке r стоит 1 \n
+	Сложность \f$O(m / 64 + s)\f$, где \f$m\f$ - количество столбцов, \f$s\f$ - количество единиц
+	*/
+	template <typename F>
+	auto for_each_in_row(const size_t r, F f) const -> void {
+		for_each_bit(row(r), row_words_, f);
+	}
+
+	/**
+	Вызывает f(i) для каждой строки i, в которой в столбце c стоит 1 \n
+	Сложность \f$O(k / 64 + s)\f$, где \f$k\f$ - количество строк, \f$s\f$ - количество единиц
+	*/
+	template <typename F>
+	auto for_each_in_col(const size_t c, F f) const -> void {
+		for_each_bit(col(c), col_words_, f);
+	}
+private:
+	template <typename F>
+	static auto for_each_bit(const std::uint64_t* words, const size_t n, F& f) -> void {
+		for (size_t w = 0; w < n; ++w)
+			for (auto x = words[w]; x != 0; x &= x - 1)
+				f(w * 64 + bits::lowest(x));
+	}
+};
@@ -0,0 +1,107 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "cover_matrix.hpp"
+
+/**
+\file
+\brief	Заголовочный файл с описанием алгоритмов выбора покрытия
+
+Покрытие ищется по битовой таблице cover_matrix: строки - наборы, которые нужно покрыть,
+столбцы - импликанты. Все импликанты считаются равноценными, т.е. минимизируется
+количество импликант в покрытии.
+*/
+
+/**
+Способ выбора покрытия
+*/
+enum cover_type {
+	/**
+	Жадный: каждый раз берется импликант, покрывающий больше всего наборов
+	*/
+	c_greedy,
+	/**
+	Точный: метод ветвей и границ (аналог метода Петрика), с ограничением
+	по количеству узлов и по времени
+	*/
+	c_exact
+};
+
+/**
+\brief	Решатель задачи о покрытии.
+
+\detail Перед выбором покрытия таблицу можно сократить (reduce): существенные столбцы
+выбираются сразу, доминируемые строки и столбцы выбрасываются, пока что-то меняется.
+Жадный и точный методы затем работают только с оставшейся частью (циклическим ядром).
+
+Жадный алгоритм и точный метод ветвей и границ. Точный метод в корне сокращает таблицу
+(существенные столбцы, доминируемые строки и столбцы) до циклического ядра, а в остальных
+узлах выбирает только существенные столбцы; ветвление идет по строке с наименьшим числом столбцов,
+а нижняя граница - количество попарно независимых строк (не имеющих общих столбцов).
+Начальная верхняя граница - жадное покрытие, поэтому при исчерпании бюджета
+возвращается лучшее из найденных покрытий, не хуже жадного.
+*/
+class cover_solver {
+	/**
+	Таблица покрытия
+	*/
+	const cover_matrix& table_;
+	/**
+	Строки, которые еще нужно покрыть (битовое множество)
+	*/
+	std::vector<std::uint64_t> rows_;
+	/**
+	Столбцы, которые еще можно выбирать (битовое множество)
+	*/
+	std::vector<std::uint64_t> cols_;
+	/**
+	Лучшее найденное покрытие
+	*/
+	std::vector<size_t> best_;
+	/**
+	Количество просмотренных узлов перебора
+	*/
+	size_t nodes_ = 0;
+	/**
+	Максимальное количество узлов
+	*/
+	size_t node_limit_ = 0;
+	/**
+	Момент, после которого перебор прекращается
+	*/
+	std::chrono::steady_clock::time_point deadline_;
+	/**
+	Был ли перебор прерван по бюджету
+	*/
+	bool aborted_ = false;
+
+	auto lower_bound(const std::vector<std::uint64_t>&, const std::vector<std::uint64_t>&) const->size_t;
+	auto essentials(std::vector<std::uint64_t>&, std::vector<std::uint64_t>&, std::vector<size_t>&) const -> bool;
+	auto reduce(std::vector<std::uint64_t>&, std::vector<std::uint64_t>&, std::vector<size_t>&) const -> bool;
+	auto count(const std::vector<std::uint64_t>&) const->size_t;
+	auto search(std::vector<std::uint64_t>, std::vector<std::uint64_t>, std::vector<size_t>, const bool) -> void;
+public:
+	cover_solver(const cover_matrix& table);
+
+	auto reduce()->std::vector<size_t>;
+	auto greedy() const->std::vector<size_t>;
+	auto exact(const size_t, const std::chrono::milliseconds) -> std::vector<size_t>;
+	/**
+	Доказана ли минимальность результата exact (перебор не был прерван)
+	*/
+	auto optimal() const -> bool { return !aborted_; }
+	/**
+	Количество узлов, просмотренных точным методом
+	*/
+	auto nodes() const -> size_t { return nodes_; }
+	/**
+	Количество оставшихся строк (после reduce - размер циклического ядра)
+	*/
+	auto rows_left() const -> size_t { return count(rows_); }
+	/**
+	Количество оставшихся столбцов
+	*/
+	auto cols_left() const -> size_t { return count(cols_); }
+};
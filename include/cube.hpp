@@ -0,0 +1,350 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+/**
+\file
+\brief	Заголовочный файл с описанием упакованного представления наборов и импликант
+
+Набор (или импликант) хранится как пара машинных слов: value - значения переменных,
+mask - позиции, в которых стоит '-'. Склейка тогда сводится к XOR и подсчету единиц,
+а проверка покрытия - к AND и сравнению.
+*/
+
+/**
+Вспомогательные битовые операции. Используют встроенные функции компилятора,
+если они есть, иначе - переносимую реализацию
+*/
+namespace bits {
+	/**
+	Количество единичных битов в слове \n
+	Сложность \f$O(1)\f$
+	*/
+	inline auto popcount(std::uint64_t x) -> std::size_t {
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<std::size_t>(__builtin_popcountll(x));
+#else
+		x = x - ((x >> 1) & 0x5555555555555555ULL);
+		x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+		x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+		return static_cast<std::size_t>((x * 0x0101010101010101ULL) >> 56);
+#endif
+	}
+
+	/**
+	Номер младшего единичного бита. Слово не должно быть нулевым \n
+	Сложность \f$O(1)\f$
+	*/
+	inline auto lowest(std::uint64_t x) -> std::size_t {
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<std::size_t>(__builtin_ctzll(x));
+#else
+		return popcount((x & (~x + 1)) - 1);
+#endif
+	}
+
+	/**
+	Номер старшего единичного бита. Слово не должно быть нулевым \n
+	Сложность \f$O(1)\f$
+	*/
+	inline auto highest(std::uint64_t x) -> std::size_t {
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<std::size_t>(63 - __builtin_clzll(x));
+#else
+		std::size_t res = 0;
+		for (std::size_t s = 32; s != 0; s >>= 1)
+			if (x >> s) {
+				x >>= s;
+				res += s;
+			}
+		return res;
+#endif
+	}
+}
+
+/**
+\brief	Упакованный набор (куб).
+
+\detail Хранит W слов значений и W слов маски, т.е. до 64 * W переменных.
+Бит i соответствует переменной с номером (n - 1 - i), где n - количество
+переменных функции, так что минтерм, записанный числом, совпадает с value.
+В позициях маски биты value всегда нулевые, поэтому кубы можно сравнивать побитово.
+
+Строковое представление (через to_string) совпадает с тем, которое использовалось
+классом Quine_McCluskey_Simplifier раньше: '0', '1' и '-', переменная x0 - слева.
+*/
+template <std::size_t W>
+class basic_cube {
+	/**
+	Значения переменных (1 - переменная входит без отрицания)
+	*/
+	std::uint64_t value_[W];
+	/**
+	Позиции, в которых переменная отсутствует ('-')
+	*/
+	std::uint64_t mask_[W];
+public:
+	enum : std::size_t {
+		/**
+		Количество слов в кубе
+		*/
+		words = W,
+		/**
+		Максимальное количество переменных
+		*/
+		max_vars = 64 * W
+	};
+
+	/**
+	Конструктор по умолчанию - набор из одних нулей \n
+	Сложность \f$O(W)\f$
+	*/
+	basic_cube() {
+		for (std::size_t w = 0; w < W; ++w)
+			value_[w] = mask_[w] = 0;
+	}
+
+	/**
+	Конструктор по номеру набора (минтерму) \n
+	Сложность \f$O(W)\f$
+	\param[in]	minterm		Номер набора
+	*/
+	explicit basic_cube(std::uint64_t minterm) : basic_cube() {
+		value_[0] = minterm;
+	}
+
+	/**
+	Конструктор по словам значений и маски (младшие 64 переменные) \n
+	Сложность \f$O(W)\f$
+	\param[in]	value		Значения переменных
+	\param[in]	mask		Позиции '-'
+	*/
+	basic_cube(std::uint64_t value, std::uint64_t mask) : basic_cube() {
+		value_[0] = value & ~mask;
+		mask_[0] = mask;
+	}
+
+	/**
+	Строит куб по всем словам значений и маски \n
+	Сложность \f$O(W)\f$
+	\param[in]	value		W слов значений переменных
+	\param[in]	mask		W слов позиций '-'
+	*/
+	static auto from_words(const std::uint64_t* value, const std::uint64_t* mask) -> basic_cube {
+		basic_cube res;
+		for (std::size_t w = 0; w < W; ++w) {
+			res.value_[w] = value[w] & ~mask[w];
+			res.mask_[w] = mask[w];
+		}
+		return res;
+	}
+
+	/**
+	Строит куб по строке из символов '0', '1' и '-' \n
+	Сложность \f$O(n)\f$, где \f$n\f$ - длина строки
+	\param[in]	str		Строка, x0 - первый символ
+	\throw	logic_error	Исключение, если строка длиннее max_vars или содержит другие символы
+	*/
+	static auto from_string(const std::string& str) -> basic_cube {
+		if (str.size() > max_vars)
+			throw std::logic_error("Too many variables.");
+		basic_cube res;
+		const auto n = str.size();
+		for (std::size_t i = 0; i < n; ++i) {
+			const auto bit = n - 1 - i;
+			switch (str[i]) {
+			case '1':
+				res.value_[bit / 64] |= std::uint64_t(1) << (bit % 64);
+				break;
+			case '-':
+				res.mask_[bit / 64] |= std::uint64_t(1) << (bit % 64);
+				break;
+			case '0':
+				break;
+			default:
+				throw std::logic_error("Incorrect input.");
+			}
+		}
+		return res;
+	}
+
+	/**
+	Строковое представление куба \n
+	Сложность \f$O(n)\f$
+	\param[in]	vars	Количество переменных функции
+	\param[out]	res		Строка из символов '0', '1' и '-'
+	*/
+	auto to_string(std::size_t vars) const -> std::string {
+		std::string res(vars, '0');
+		for (std::size_t i = 0; i < vars; ++i) {
+			const auto bit = vars - 1 - i;
+			if (test(mask_, bit))
+				res[i] = '-';
+			else if (test(value_, bit))
+				res[i] = '1';
+		}
+		return res;
+	}
+
+	/**
+	Вес куба - количество единиц в нем \n
+	Сложность \f$O(W)\f$
+	*/
+	auto weight() const -> std::size_t {
+		std::size_t res = 0;
+		for (std::size_t w = 0; w < W; ++w)
+			res += bits::popcount(value_[w]);
+		return res;
+	}
+
+	/**
+	Соседние ли кубы? Соседними считаются кубы с одинаковыми масками,
+	различающиеся ровно в одной координате \n
+	Сложность \f$O(W)\f$
+	*/
+	auto is_neighbor(const basic_cube& o) const -> bool {
+		std::uint64_t masks = 0;
+		std::size_t diff = 0;
+		for (std::size_t w = 0; w < W; ++w) {
+			masks |= mask_[w] ^ o.mask_[w];
+			diff += bits::popcount(value_[w] ^ o.value_[w]);
+		}
+		return (masks == 0) & (diff == 1);
+	}
+
+	/**
+	Склейка с соседним кубом: различающаяся координата заменяется на '-'.
+	Результат имеет смысл только для соседних кубов \n
+	Сложность \f$O(W)\f$
+	*/
+	auto merge(const basic_cube& o) const -> basic_cube {
+		basic_cube res;
+		for (std::size_t w = 0; w < W; ++w) {
+			const auto diff = value_[w] ^ o.value_[w];
+			res.value_[w] = value_[w] & ~diff;
+			res.mask_[w] = mask_[w] | diff;
+		}
+		return res;
+	}
+
+	/**
+	Совпадают ли позиции '-' у двух кубов \n
+	Сложность \f$O(W)\f$
+	*/
+	auto same_mask(const basic_cube& o) const -> bool {
+		std::uint64_t res = 0;
+		for (std::size_t w = 0; w < W; ++w)
+			res |= mask_[w] ^ o.mask_[w];
+		return res == 0;
+	}
+
+	/**
+	Упорядочивание кубов только по маске - нужно, чтобы разложить группы на корзины
+	с одинаковыми позициями '-' \n
+	Сложность \f$O(W)\f$
+	*/
+	auto mask_less(const basic_cube& o) const -> bool {
+		for (std::size_t w = W; w-- > 0;)
+			if (mask_[w] != o.mask_[w])
+				return mask_[w] < o.mask_[w];
+		return false;
+	}
+
+	/**
+	Покрывает ли данный куб куб o (т.е. o целиком лежит внутри *this) \n
+	Сложность \f$O(W)\f$
+	*/
+	auto covers(const basic_cube& o) const -> bool {
+		std::uint64_t res = 0;
+		for (std::size_t w = 0; w < W; ++w)
+			res |= (o.mask_[w] & ~mask_[w]) | ((o.value_[w] ^ value_[w]) & ~mask_[w]);
+		return res == 0;
+	}
+
+	/**
+	Количество переменных, необходимых для записи куба (номер старшего значащего бита + 1) \n
+	Сложность \f$O(W)\f$
+	*/
+	auto bit_length() const -> std::size_t {
+		for (std::size_t w = W; w-- > 0;) {
+			const auto x = value_[w] | mask_[w];
+			if (x)
+				return w * 64 + bits::highest(x) + 1;
+		}
+		return 0;
+	}
+
+	/**
+	Хеш куба для хеш-таблиц с открытой адресацией (перемешивание в стиле splitmix64) \n
+	Сложность \f$O(W)\f$
+	*/
+	auto hash() const -> std::uint64_t {
+		std::uint64_t h = 0x9E3779B97F4A7C15ULL;
+		for (std::size_t w = 0; w < W; ++w) {
+			h = mix(h ^ value_[w]);
+			h = mix(h ^ mask_[w]);
+		}
+		return h;
+	}
+
+	auto value(std::size_t w) const -> std::uint64_t { return value_[w]; }
+	auto mask(std::size_t w) const -> std::uint64_t { return mask_[w]; }
+
+	auto operator==(const basic_cube& o) const -> bool {
+		std::uint64_t res = 0;
+		for (std::size_t w = 0; w < W; ++w)
+			res |= (value_[w] ^ o.value_[w]) | (mask_[w] ^ o.mask_[w]);
+		return res == 0;
+	}
+
+	auto operator!=(const basic_cube& o) const -> bool {
+		return !(*this == o);
+	}
+
+	/**
+	Порядок совпадает с лексикографическим порядком строковых представлений
+	('-' < '0' < '1', x0 - старший разряд), поэтому вывод МДНФ не изменился \n
+	Сложность \f$O(W)\f$
+	*/
+	auto operator<(const basic_cube& o) const -> bool {
+		for (std::size_t w = W; w-- > 0;) {
+			const auto diff = (value_[w] ^ o.value_[w]) | (mask_[w] ^ o.mask_[w]);
+			if (diff) {
+				const auto bit = std::uint64_t(1) << bits::highest(diff);
+				return rank(value_[w], mask_[w], bit) < rank(o.value_[w], o.mask_[w], bit);
+			}
+		}
+		return false;
+	}
+private:
+	static auto test(const std::uint64_t* x, std::size_t bit) -> bool {
+		return ((x[bit / 64] >> (bit % 64)) & 1) != 0;
+	}
+
+	static auto mix(std::uint64_t x) -> std::uint64_t {
+		x += 0x9E3779B97F4A7C15ULL;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+		return x ^ (x >> 31);
+	}
+
+	static auto rank(std::uint64_t value, std::uint64_t mask, std::uint64_t bit) -> int {
+		if (mask & bit)
+			return 0;
+		return (value & bit) ? 2 : 1;
+	}
+};
+
+/**
+Куб до 64 переменных - тип, с которым работают Quine_McCluskey_Simplifier и остальные
+классы минимизации
+*/
+using cube = basic_cube<1>;
+
+/**
+Куб до 128 переменных - для функций больше чем от 64 переменных. Все наборы такой
+функции не перебрать, поэтому они минимизируются только эвристикой (wide_espresso)
+*/
+using wide_cube = basic_cube<2>;
@@ -0,0 +1,118 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "cube.hpp"
+
+/**
+\file
+\brief	Заголовочный файл с описанием хеш-множества кубов
+
+Используется вместо линейного поиска по вектору (бывшая in_vect) везде,
+где нужно проверить, встречался ли уже набор или импликант.
+*/
+
+/**
+\brief	Хеш-множество кубов с открытой адресацией.
+
+\detail Линейное пробирование, размер таблицы - степень двойки, коэффициент
+заполнения не больше 1/2. Удаления не поддерживаются - они не нужны алгоритму.
+Вставка и проверка наличия в среднем \f$O(1)\f$.
+*/
+template <typename T>
+class basic_cube_set {
+	/**
+	Ячейки таблицы
+	*/
+	std::vector<T> slots_;
+	/**
+	Признак занятости ячейки
+	*/
+	std::vector<std::uint8_t> used_;
+	/**
+	Количество элементов
+	*/
+	std::size_t size_ = 0;
+
+	auto find_slot(const T& x) const -> std::size_t {
+		const auto m = slots_.size() - 1;
+		auto i = static_cast<std::size_t>(x.hash()) & m;
+		while (used_[i] && slots_[i] != x)
+			i = (i + 1) & m;
+		return i;
+	}
+
+	auto rehash(std::size_t capacity) -> void {
+		std::vector<T> slots(capacity);
+		std::vector<std::uint8_t> used(capacity, 0);
+		slots.swap(slots_);
+		used.swap(used_);
+		for (std::size_t i = 0; i < slots.size(); ++i)
+			if (used[i]) {
+				const auto j = find_slot(slots[i]);
+				slots_[j] = slots[i];
+				used_[j] = 1;
+			}
+	}
+public:
+	basic_cube_set() {
+		rehash(16);
+	}
+
+	template <typename It>
+	basic_cube_set(It first, It last) : basic_cube_set() {
+		for (; first != last; ++first)
+			insert(*first);
+	}
+
+	/**
+	Резервирует место под n элементов без перехеширования \n
+	Сложность \f$O(n)\f$
+	*/
+	auto reserve(std::size_t n) -> void {
+		std::size_t capacity = slots_.size();
+		while (capacity < 2 * n)
+			capacity *= 2;
+		if (capacity != slots_.size())
+			rehash(capacity);
+	}
+
+	/**
+	Вставляет элемент \n
+	Сложность \f$O(1)\f$ в среднем
+	\param[out]	true/false	true, если элемента еще не было в множестве
+	*/
+	auto insert(const T& x) -> bool {
+		if (2 * (size_ + 1) > slots_.size())
+			rehash(2 * slots_.size());
+		const auto i = find_slot(x);
+		if (used_[i])
+			return false;
+		slots_[i] = x;
+		used_[i] = 1;
+		++size_;
+		return true;
+	}
+
+	/**
+	Проверяет наличие элемента \n
+	Сложность \f$O(1)\f$ в среднем
+	*/
+	auto contains(const T& x) const -> bool {
+		return used_[find_slot(x)] != 0;
+	}
+
+	auto size() const -> std::size_t { return size_; }
+	auto empty() const -> bool { return size_ == 0; }
+
+	auto clear() -> void {
+		std::fill(used_.begin(), used_.end(), 0);
+		size_ = 0;
+	}
+};
+
+/**
+Множество кубов, с которыми работает Quine_McCluskey_Simplifier
+*/
+using cube_set = basic_cube_set<cube>;
@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "cube.hpp"
+
+/**
+\file
+\brief	Заголовочный файл с описанием эвристической минимизации в стиле Espresso
+
+Метод Квайна-МакКласки перебирает все простые импликанты, и после ~20 переменных их
+слишком много. Эвристика Espresso работает только с текущим покрытием: расширяет кубы
+до простых (EXPAND), выбрасывает лишние (IRREDUNDANT) и сужает оставшиеся (REDUCE),
+пока покрытие уменьшается.
+*/
+
+/**
+Способ минимизации
+*/
+enum engine_type {
+	/**
+	Метод Квайна-МакКласки: все простые импликанты и выбор покрытия
+	*/
+	e_quine_mccluskey,
+	/**
+	Как e_quine_mccluskey, но простые импликанты строятся неявно, в виде ZDD
+	по диаграмме решений функции, без раундов склейки
+	*/
+	e_implicit,
+	/**
+	Эвристика Espresso: результат близок к минимальному, но минимальность не гарантируется
+	*/
+	e_espresso
+};
+
+/**
+\brief	Эвристическая минимизация в стиле Espresso.
+
+\detail Дополнение функции (множество нулей) не строится. Все проверки сводятся
+к вопросу "лежит ли куб c в покрытии F и неопределенных наборах D", который решается
+как проверка тождественной истинности (tautology) кофактора (F + D) по c
+рекурсивным разложением по самой бинарной переменной, с отбрасыванием монотонных переменных.
+Кубы - basic_cube<W>, т.е. переменных не больше 64 * W: espresso работает с cube,
+wide_espresso - с wide_cube (до 128 переменных).
+*/
+template <std::size_t W>
+class basic_espresso {
+public:
+	using cube_type = basic_cube<W>;
+	/**
+	Множество переменных: бит k слова w - переменная 64 * w + k
+	*/
+	using var_set = std::array<std::uint64_t, W>;
+private:
+	/**
+	Количество переменных
+	*/
+	size_t vars_;
+	/**
+	Биты, соответствующие переменным
+	*/
+	var_set all_;
+	/**
+	Наборы, на которых значение функции не определено
+	*/
+	std::vector<cube_type> dont_cares_;
+
+	auto contains(const std::vector<cube_type>&, const size_t, const cube_type&) const -> bool;
+	auto tautology(std::vector<cube_type>, var_set) const -> bool;
+	auto expand(std::vector<cube_type>&) const -> void;
+	auto irredundant(std::vector<cube_type>&) const -> void;
+	auto reduce(std::vector<cube_type>&) const -> void;
+	auto literals(const std::vector<cube_type>&) const -> size_t;
+public:
+	basic_espresso(const size_t vars, const std::vector<cube_type>& dont_cares);
+
+	auto minimize(const std::vector<cube_type>&, const size_t iterations = 64) const -> std::vector<cube_type>;
+};
+
+using espresso = basic_espresso<1>;
+using wide_espresso = basic_espresso<2>;
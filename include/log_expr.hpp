@@ -1,5 +1,7 @@
 #pragma once
+#include <algorithm>
 #include <bitset>
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <set>
@@ -8,6 +10,8 @@
 #include <sstream>
 #include <tuple>
 #include <regex>
+#include "bdd.hpp"
+#include "cube.hpp"
 
 /**
 \brief	Парсер логических формул.
@@ -57,21 +61,27 @@ class log_expr {
 		*/
 		op_or,
 		/**
-		Операция НЕ. Создается отдельный узел, где first = nullptr, а second - аргумент операции НЕ
+		Операция НЕ. Создается отдельный узел, где first = no_node, а second - аргумент операции НЕ
 		*/
 		op_not
 	};
 
+	/**
+	Номер несуществующего узла
+	*/
+	enum : size_t { no_node = ~size_t(0) };
+
 	/**
 	\brief Узел дерева
 
-	\detail Структура, представляющая собой узлы (вершины) дерева
+	\detail Структура, представляющая собой узлы (вершины) дерева. Узлы лежат подряд
+	в nodes_, а связи между ними - номера узлов в nodes_ (no_node - нет узла)
 	*/
 	struct exp_node {
 		/**
 		Родительский узел
 		*/
-		exp_node* prev;
+		size_t prev;
 		/**
 		Тип узла, представлен структтурой exp_type
 		*/
@@ -83,7 +93,7 @@ class log_expr {
 		/**
 		Первый операнд
 		*/
-		exp_node* first;
+		size_t first;
 		/**
 		Сама операция между двумя операндами
 		*/
@@ -91,21 +101,51 @@ class log_expr {
 		/**
 		Второй операнд
 		*/
-		exp_node* second;
+		size_t second;
 
-		exp_node(exp_node* prev, exp_type type, size_t data = 0);
-		exp_node(const exp_node& o);
-		~exp_node();
+		exp_node(size_t prev, exp_type type, size_t data = 0);
 
-		auto process(std::vector<bool>&) const -> bool;
 		auto state() const->size_t;
 	};
 
+	/**
+	\brief Инструкция постфиксной записи формулы
+
+	\detail op_null - положить на стек значение переменной data,
+	op_not - заменить вершину стека ее отрицанием, op_and и op_or - заменить
+	две верхние ячейки стека результатом операции
+	*/
+	struct instr {
+		op_type operation;
+		size_t data;
+	};
+
 	std::vector<std::string> ids_;
-	exp_node* root_;
+	/**
+	Все узлы дерева (арена), nodes_[0] - корень. Дерево освобождается вместе с вектором,
+	без рекурсии по узлам
+	*/
+	std::vector<exp_node> nodes_;
+	/**
+	Формула в постфиксной записи. Вычисляется сразу на 64 наборах: каждая ячейка стека -
+	машинное слово, бит i которого - значение на i-м наборе
+	*/
+	std::vector<instr> code_;
+	/**
+	Необходимая глубина стека для вычисления code_
+	*/
+	size_t depth_ = 0;
+
+	auto add_node(size_t, exp_type, size_t data = 0) -> size_t;
+	auto compile() -> void;
+	auto eval(const size_t, std::vector<std::uint64_t>&) const->std::uint64_t;
 public:
 	log_expr(const std::string&);
 	auto print(std::ostream& os = std::cout) const -> void;
-
-	~log_expr();
+	auto minterms() const->std::vector<std::uint64_t>;
+	auto to_bdd(bdd&) const->size_t;
+	/**
+	Количество переменных формулы (в порядке первого появления)
+	*/
+	auto variables() const -> size_t { return ids_.size(); }
 };
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+/**
+\file
+\brief	Заголовочный файл с описанием отображения файла в память
+
+Большой вектор значений (2^24 символов и больше) не нужно копировать в строки:
+файл отображается в память целиком, и разбор идет прямо по его байтам.
+*/
+
+/**
+\brief	Файл, отображенный в память только для чтения.
+
+\detail На POSIX-системах используется mmap, на Windows - CreateFileMapping.
+Пустой файл не отображается: data() тогда равен nullptr, а size() - нулю.
+Объект нельзя копировать, отображение снимается в деструкторе.
+*/
+class mapped_file {
+	/**
+	Начало отображения
+	*/
+	const char* data_ = nullptr;
+	/**
+	Размер файла в байтах
+	*/
+	size_t size_ = 0;
+#if defined(_WIN32)
+	/**
+	Дескрипторы файла и отображения
+	*/
+	void* file_ = nullptr;
+	void* mapping_ = nullptr;
+#endif
+public:
+	explicit mapped_file(const std::string& file_name);
+	mapped_file(const mapped_file&) = delete;
+	auto operator=(const mapped_file&) -> mapped_file& = delete;
+	~mapped_file();
+
+	auto data() const -> const char* { return data_; }
+	auto size() const -> size_t { return size_; }
+	auto begin() const -> const char* { return data_; }
+	auto end() const -> const char* { return data_ + size_; }
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "Quine_McCluskey_Simplifier.hpp"
+
+/**
+\file
+\brief	Заголовочный файл с описанием многовыходной минимизации
+
+Несколько функций от одних и тех же переменных (выходы PLA) минимизируются вместе:
+каждому кубу приписана маска выходов, для которых он является импликантом, и одно
+и то же произведение, использованное несколькими выходами, считается один раз.
+*/
+
+/**
+\brief	Многовыходной метод Квайна-МакКласки.
+
+\detail Каждый набор помечается маской выходов, на которых функция равна единице или
+не определена. Склеиваются только кубы с пересекающимися масками, маска результата -
+пересечение масок. Куб простой, если ни одна склейка не сохранила его маску целиком.
+Таблица покрытия общая: строки - пары (выход, набор, на котором выход равен единице),
+столбцы - простые кубы; минимизируется количество различных кубов (строк PLA).
+Выходов не больше 64.
+*/
+class multi_output_simplifier {
+	/**
+	Куб с маской выходов
+	*/
+	struct tagged_cube {
+		cube set;
+		std::uint64_t outputs;
+		bool merged;
+	};
+	/**
+	Единицы каждого выхода
+	*/
+	std::vector<std::vector<cube>> ones_;
+	/**
+	Наборы вместе с масками выходов, на которых функция равна единице или не определена
+	*/
+	std::vector<tagged_cube> sets_;
+	/**
+	Простые кубы с масками выходов
+	*/
+	std::vector<tagged_cube> implicants_;
+	/**
+	Выбранные кубы (отсортированы) и маски выходов, которые их используют
+	*/
+	std::vector<std::pair<cube, std::uint64_t>> terms_;
+	/**
+	Количество переменных
+	*/
+	size_t vars_ = 0;
+	/**
+	Доказана ли минимальность количества кубов
+	*/
+	bool minimal_ = false;
+
+	auto combine_round(std::vector<tagged_cube>&, std::vector<tagged_cube>&) -> void;
+	auto get_implicants() -> void;
+public:
+	multi_output_simplifier() {};
+
+	auto init(const std::vector<boolean_function>&) -> void;
+	auto simplify(const simplify_options& options = simplify_options()) -> void;
+	auto outputs() const -> size_t { return ones_.size(); }
+	auto variables() const -> size_t { return vars_; }
+	auto is_minimal() const -> bool { return minimal_; }
+	auto terms() const -> const std::vector<std::pair<cube, std::uint64_t>>& { return terms_; }
+	auto mdnf(const size_t) const -> std::vector<cube>;
+	auto print_mdnf(std::ostream& os = std::cout) const -> void;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Quine_McCluskey_Simplifier.hpp"
+
+/**
+\file
+\brief	Заголовочный файл с описанием кэша результатов минимизации
+
+Одни и те же функции минимизируются снова и снова (при каждой сборке). Результат
+запоминается в файле под ключом - хэшем функции и параметров, и при следующем запуске
+берется оттуда без минимизации.
+*/
+
+/**
+\brief	Ключ записи кэша.
+
+\detail Два независимых хэша одних и тех же данных: по hash ищется запись, а check
+проверяется при находке, так что совпадение одного hash у разных функций не выдает
+чужой результат
+*/
+struct cache_key {
+	std::uint64_t hash;
+	std::uint64_t check;
+};
+
+/**
+\brief	Кэш результатов минимизации в файле.
+
+\detail Файл текстовый, одна запись на строку: ключ (hash и check), количество переменных,
+доказана ли минимальность, кубы МДНФ (value:mask в шестнадцатеричном виде) и в конце -
+контрольная сумма строки. Новые записи дописываются в конец файла сразу; строки, у которых
+контрольная сумма не сходится (недописанные или испорченные), при чтении пропускаются.
+Для одного ключа действует последняя запись. Методы можно вызывать из нескольких потоков.
+*/
+class result_cache {
+	/**
+	Запись в памяти: второй хэш ключа и результат
+	*/
+	struct entry {
+		std::uint64_t check;
+		simplify_result result;
+	};
+
+	/**
+	Записи в памяти (по первому хэшу ключа)
+	*/
+	std::unordered_map<std::uint64_t, entry> entries_;
+	/**
+	Файл, открытый на дозапись
+	*/
+	std::ofstream file_;
+	/**
+	Защищает entries_ и file_
+	*/
+	mutable std::mutex lock_;
+public:
+	/**
+	Версия ключа и формата записей. Входит в ключ, поэтому при изменении хэша, формата
+	или значений перечислений из simplify_options (engine_type, cover_type) ее нужно
+	увеличить - старые записи тогда просто не находятся
+	*/
+	enum : std::uint64_t { version = 2 };
+
+	explicit result_cache(const std::string& file_name);
+
+	static auto key(const std::vector<cube>&, const std::vector<cube>&, const size_t, const simplify_options&) -> cache_key;
+	static auto cacheable(const simplify_options&, const simplify_result&) -> bool;
+
+	auto find(const cache_key&, simplify_result&) const -> bool;
+	auto insert(const cache_key&, const simplify_result&) -> void;
+	auto size() const -> size_t;
+};
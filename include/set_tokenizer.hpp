@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+\file
+\brief	Заголовочный файл с описанием разбора списка номеров наборов
+
+Список номеров - строки вида "1 4 10 d 2 3": десятичные числа, разделенные любыми
+другими символами, а "d" переключает остаток строки на неопределенные наборы.
+Разбор идет за один проход по буферу, без регулярных выражений и без выделения памяти.
+*/
+
+/**
+\brief	Разбор списка номеров наборов.
+
+\detail Числа читаются прямо в std::uint64_t (или, для функций больше чем от 64 переменных,
+в несколько слов). Символ 'd' (в любом месте строки)
+означает, что следующие номера до конца строки - неопределенные наборы;
+перевод строки сбрасывает этот признак. Все остальные символы - разделители.
+*/
+class set_tokenizer {
+	/**
+	Текущая позиция в буфере
+	*/
+	const char* pos_;
+	/**
+	Конец буфера
+	*/
+	const char* last_;
+	/**
+	Встретился ли 'd' в текущей строке
+	*/
+	bool dont_care_ = false;
+
+	auto skip() -> bool;
+public:
+	set_tokenizer(const char* first, const char* last) : pos_(first), last_(last) {};
+
+	auto next(std::uint64_t&) -> bool;
+	auto next(std::uint64_t*, const size_t) -> bool;
+	/**
+	Относится ли последний прочитанный номер к неопределенным наборам
+	*/
+	auto dont_care() const -> bool { return dont_care_; }
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+\file
+\brief	Заголовочный файл с описанием разбора вектора значений функции
+
+Вектор значений - строка из символов '0', '1' и '-'. Разбор проверяет символы и
+выписывает номера позиций '1' и '-' сразу блоками по 16 (SSE2) или 32 (AVX2) символа:
+сравнения дают битовые маски, из которых номера извлекаются по младшему биту.
+Без SSE2 используется обычный посимвольный разбор.
+*/
+
+/**
+Разбор вектора значений функции
+*/
+namespace vector_scan {
+	auto scan(const char* data, const size_t size, const std::uint64_t base,
+		std::vector<std::uint64_t>& ones, std::vector<std::uint64_t>& dont_cares) -> bool;
+	auto scan_scalar(const char* data, const size_t size, const std::uint64_t base,
+		std::vector<std::uint64_t>& ones, std::vector<std::uint64_t>& dont_cares) -> bool;
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "bdd.hpp"
+#include "cube.hpp"
+
+/**
+\file
+\brief	Заголовочный файл с описанием диаграмм решений с подавлением нулей (ZDD)
+
+ZDD хранит семейство множеств; здесь - множество кубов, куб - множество литералов.
+Литерал 2k - отрицание переменной k, литерал 2k + 1 - сама переменная k. Простые импликанты
+функции строятся по ее BDD сразу в виде ZDD (метод Кудера-Мадра), без промежуточных
+кубов, которые перебирает метод Квайна-МакКласки.
+*/
+
+/**
+\brief	Менеджер ZDD для множеств кубов.
+
+\detail Узел с пустой ветвью "литерал есть" не создается, поэтому множества кубов
+с малым количеством литералов хранятся компактно. Объединение и разность
+запоминаются в computed_.
+*/
+class zdd {
+	/**
+	Узел: литерал, кубы без него (low) и кубы с ним, из которых он убран (high)
+	*/
+	struct node {
+		size_t var;
+		size_t low;
+		size_t high;
+	};
+
+	struct triple {
+		size_t a;
+		size_t b;
+		size_t c;
+
+		auto operator==(const triple& o) const -> bool {
+			return a == o.a && b == o.b && c == o.c;
+		}
+	};
+
+	struct triple_hash {
+		auto operator()(const triple& t) const -> size_t {
+			auto h = static_cast<std::uint64_t>(t.a) * 0x9E3779B97F4A7C15ULL;
+			h ^= static_cast<std::uint64_t>(t.b) * 0xC2B2AE3D27D4EB4FULL + (h >> 29);
+			h ^= static_cast<std::uint64_t>(t.c) * 0x165667B19E3779F9ULL + (h >> 32);
+			return static_cast<size_t>(h);
+		}
+	};
+
+	/**
+	Все узлы, nodes_[0] - пустое семейство, nodes_[1] - семейство из пустого куба
+	*/
+	std::vector<node> nodes_;
+	/**
+	Таблица уникальности: (литерал, low, high) -> узел
+	*/
+	std::unordered_map<triple, size_t, triple_hash> unique_;
+	/**
+	Кэш операций: (p, q, операция) -> результат
+	*/
+	std::unordered_map<triple, size_t, triple_hash> computed_;
+
+	auto make(const size_t, const size_t, const size_t) -> size_t;
+	auto primes(bdd&, const size_t, std::unordered_map<size_t, size_t>&) -> size_t;
+
+	/**
+	Обход семейства: ветвь high добавляет литерал в куб. Глубина рекурсии - не больше
+	количества литералов, кубы не запоминаются \n
+	Сложность \f$O(c \cdot n)\f$, где \f$c\f$ - количество кубов
+	*/
+	template <typename F>
+	auto visit(const size_t p, const std::uint64_t value, const std::uint64_t mask, F& f) const -> void {
+		if (p == empty)
+			return;
+		if (p == base) {
+			f(cube(value, mask));
+			return;
+		}
+		const auto& x = nodes_[p];
+		const auto bit = std::uint64_t(1) << (x.var / 2);
+		visit(x.low, value, mask, f);
+		visit(x.high, (x.var % 2) ? value | bit : value, mask & ~bit, f);
+	}
+public:
+	/**
+	Пустое семейство и семейство из одного пустого куба (тождественная единица)
+	*/
+	enum : size_t { empty = 0, base = 1 };
+
+	zdd();
+
+	auto unite(const size_t, const size_t) -> size_t;
+	auto difference(const size_t, const size_t) -> size_t;
+	auto primes(bdd&, const size_t) -> size_t;
+	auto count(const size_t) const -> std::uint64_t;
+	auto cubes(const size_t, const size_t vars) const -> std::vector<cube>;
+
+	/**
+	Вызывает f для каждого куба семейства p, не выписывая семейство целиком,
+	так что память не зависит от количества кубов
+	*/
+	template <typename F>
+	auto for_each(const size_t p, const size_t vars, F f) const -> void {
+		visit(p, 0, vars >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << vars) - 1, f);
+	}
+
+	/**
+	Количество узлов (вместе с константами)
+	*/
+	auto size() const -> size_t { return nodes_.size(); }
+};
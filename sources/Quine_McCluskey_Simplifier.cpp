@@ -1,4 +1,5 @@
 #include "Quine_McCluskey_Simplifier.hpp"
+#include "result_cache.hpp"
 
 
 /*! \mainpage Домашнее задание по АиСД
@@ -12,7 +13,7 @@
 *
 * \section complexity Сложности
 * \subsection time Сложность по времени
-* \f$O(log(k) \cdot (k \cdot n^3) + k \cdot n \cdot m^2 + k \cdot n^3 + k^2)\f$, где \f$k\f$ - количество единиц функции, \f$n\f$ - количество переменных, \f$m\f$ - количество импликант 
+* \f$O(log(k) \cdot (k \cdot n^2) + k \cdot m + s \cdot log(s))\f$, где \f$k\f$ - количество единиц функции, \f$n\f$ - количество переменных, \f$m\f$ - количество импликант, \f$s\f$ - количество единиц в таблице покрытия
 * \subsection memory Сложность по памяти
 * \f$ O(n \cdot m) \f$, где \f$ n \f$ - количество единиц функции, \f$ m \f$ - количество импликант функции
 *
@@ -48,166 +49,204 @@ Source.cpp в папку /tests. Source.cpp находится в папке /to
 
 /**
 Конструктор объекта класса. Создает объект по входному файлу (его имени), заполняя
-поле input_sets и выравнивая наборы по количеству перменных \n
-Сложность \f$O(2^m + n)\f$, где \f$m\f$ - длина регулярного выражения, 
-\f$n\f$ - длина входной строки (из файла)
+поля input_sets и dont_cares (формат - как у init с sets = true) и определяя количество перменных.
+Файл отображается в память и разбирается на месте (см. mapped_file) \n
+Сложность \f$O(n)\f$, где \f$n\f$ - длина входной строки (из файла)
 
 \param[in]		file_name	Имя открываемого файла
 \throw			logic_error	Исключение, если файл не был открыт
 */
 Quine_McCluskey_Simplifier::Quine_McCluskey_Simplifier(const std::string & file_name) {
-	std::ifstream input(file_name);
-	std::string temp;
-	std::smatch m;
-	std::regex e("d+");
-	if (!input.is_open())
-		throw std::logic_error("File not opened.");
-	while (input.good()) {
-		getline(input, temp);
-		while (std::regex_search(temp, m, e)) {
-			for (auto x : m)
-				if (!in_vect(input_sets_, string_base10_to_base2(x)))
-					input_sets_.push_back(string_base10_to_base2(x));
-			temp = m.suffix().str();
-		}
-	}
-	const size_t m_l = num_of_vars();
-	groups_.resize(m_l + 1);
-	for (auto i = 0; i < input_sets_.size(); ++i) {
-		align(i, m_l);
-	}
-	input.close();
+	init(file_name, true);
 }
 
 /**
 Конструктор объекта класса. Создает объект по входному потоку, заполняя
-поле input_sets и выравнивая наборы по количеству перменных. Предполагается, что
+поле input_sets и определяя количество перменных. Предполагается, что
 вектор будет записан в одну строку, так что есть проверка на то, чтобы длина строки была
-степенью двойки \n
+степенью двойки. Символ '-' в векторе означает, что значение функции на этом наборе
+не определено (набор попадает в dont_cares). Строка проверяется и разбирается блоками
+(см. vector_scan::scan) \n
 Сложность \f$O(n + k)\f$, где \f$n\f$ - длина входной строки (из потока), 
 \f$k\f$ - количество значимых единиц функции
 \param[in]		ss	Входной поток
 \throw	logic_error	Исключение, если размер вектора не является степенью двойки
-\throw	logic_error	Исключение, если встретились символы, отличные от "0" и "1"
+\throw	logic_error	Исключение, если встретились символы, отличные от "0", "1" и "-"
 */
 Quine_McCluskey_Simplifier::Quine_McCluskey_Simplifier(std::istream & ss) {
-	std::string temp;
-	while (ss.good()) {
-		getline(ss, temp); 
-		if (!((temp.size() == 0) ? 0 : (temp.size() & (temp.size() - 1)) == 0))
-			throw std::logic_error("Size of vector is invalid. Check your input.");
+	init(ss, false);
+}
 
-		for (size_t i = 0; i < temp.length(); ++i) {
-			if (!(temp[i] == '1' || temp[i] == '0'))
-				throw std::logic_error("Incorrect input.");
-			if (temp[i] == '1')
-				if (!in_vect(input_sets_, string_base10_to_base2(std::to_string(i))))
-					input_sets_.push_back(string_base10_to_base2(std::to_string(i)));
+/**
+Склеивает наборы из соседних групп groups[i] и groups[i + 1]. Сравниваются только
+корзины с одинаковыми масками - наборы с разными позициями '-' склеить нельзя.
+Склеенные наборы отмечаются, новые кубы (без повторов) дописываются в out \n
+Сложность \f$O(\sum a_j \cdot b_j)\f$, где \f$a_j\f$ и \f$b_j\f$ - размеры корзин
+с одной и той же маской в двух группах
+\param[in]		i			Номер младшей из двух групп
+\param[in]		out			Куда дописывать склеенные кубы
+\param[in]		merged		Уже полученные в этом раунде кубы
+\param[in]		compared	Счетчик проверенных пар
+\param[out]	true/false	Была ли хотя бы одна склейка
+*/
+auto Quine_McCluskey_Simplifier::combine(const size_t i, std::vector<cube>& out, cube_set& merged, size_t& compared) -> bool {
+	auto& lo = groups_[i];
+	auto& hi = groups_[i + 1];
+	auto mask_less = [](const std::pair<cube, bool>& x, const std::pair<cube, bool>& y) {
+		return std::get<0>(x).mask_less(std::get<0>(y));
+	};
+	auto find = false;
+	size_t a = 0, b = 0;
+	while (a < lo.size() && b < hi.size()) {
+		// Границы корзин с текущими масками
+		const auto a_end = static_cast<size_t>(std::upper_bound(lo.begin() + a, lo.end(), lo[a], mask_less) - lo.begin());
+		const auto b_end = static_cast<size_t>(std::upper_bound(hi.begin() + b, hi.end(), hi[b], mask_less) - hi.begin());
+		if (mask_less(lo[a], hi[b])) {
+			a = a_end;
+			continue;
 		}
+		if (mask_less(hi[b], lo[a])) {
+			b = b_end;
+			continue;
+		}
+		compared += (a_end - a) * (b_end - b);
+		for (auto j = a; j < a_end; ++j) {
+			for (auto k = b; k < b_end; ++k) {
+				if (std::get<0>(lo[j]).is_neighbor(std::get<0>(hi[k]))) { // O(1)
+					std::get<1>(lo[j]) = true;
+					std::get<1>(hi[k]) = true;
+					const auto set = std::get<0>(lo[j]).merge(std::get<0>(hi[k]));
+					if (merged.insert(set)) // O(1)
+						out.push_back(set);
+					find = true;
+				}
+			}
+		}
+		a = a_end;
+		b = b_end;
 	}
-	
-	const size_t m_l = num_of_vars();
-	groups_.resize(m_l + 1);
-	for (auto i = 0; i < input_sets_.size(); ++i) {
-		align(i, m_l);
-	}
+	return find;
 }
 
 /**
-Выравнивает набор input_sets[i] по количеству переменных функции \n
-Сложность \f$O(n)\f$, где \f$n\f$ - длина строки, которой представлен набор
-\param[in]		index		Номер набора для выравнивания
-\param[in]		size		Количество переменных
+Один раунд склейки: обрабатывает все пары соседних групп и собирает склеенные кубы в tmp.
+Пары с разными i независимы (пара i дает кубы веса i, поэтому повторов между парами нет),
+но пары i и i + 1 отмечают наборы одной и той же группы. Поэтому при threads > 1
+сначала параллельно обрабатываются все четные пары, затем все нечетные, у каждой пары
+свой выходной буфер. Буферы сливаются в порядке i, так что результат не зависит
+от количества потоков \n
+Сложность \f$O(k \cdot n^2 / t)\f$, где \f$t\f$ - количество потоков
+\param[in]		tmp			Куда дописывать склеенные кубы
+\param[in]		compared	Счетчик проверенных пар
+\param[out]	true/false	Была ли хотя бы одна склейка
 */
-auto Quine_McCluskey_Simplifier::align(const size_t index, const size_t size) -> void {
-	const auto curr_size = input_sets_[index].size();
-	// O(size - curr_size + n) + O(n - curr_size)
-	input_sets_[index].insert(0, std::string(size - curr_size, '0'));
-	//for (auto j = 0; j < size - curr_size; ++j)
-	//	input_sets_[index].insert(input_sets_[index].begin(), '0');
+auto Quine_McCluskey_Simplifier::combine_round(std::vector<cube>& tmp, size_t& compared) -> bool {
+	const auto pairs = groups_.size() - 1;
+	auto find = false;
+	if (threads_ <= 1 || pairs <= 1) {
+		cube_set merged;
+		for (size_t i = 0; i < pairs; ++i) // Количество значимых единиц
+			if (combine(i, tmp, merged, compared))
+				find = true;
+		return find;
+	}
+
+	std::vector<std::vector<cube>> outs(pairs);
+	std::vector<char> found(pairs, 0);
+	std::vector<size_t> counts(pairs, 0);
+	std::exception_ptr error;
+	std::mutex error_lock;
+	for (size_t parity = 0; parity < 2; ++parity) {
+		std::atomic<size_t> next(parity);
+		auto worker = [&]() {
+			try {
+				cube_set merged;
+				for (auto i = next.fetch_add(2); i < pairs; i = next.fetch_add(2)) {
+					merged.clear();
+					found[i] = combine(i, outs[i], merged, counts[i]);
+				}
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> lock(error_lock);
+				error = std::current_exception();
+			}
+		};
+		std::vector<std::thread> pool;
+		const auto count = std::min(threads_, (pairs - parity + 1) / 2);
+		for (size_t t = 0; t < count; ++t)
+			pool.emplace_back(worker);
+		for (auto& t : pool)
+			t.join();
+		if (error)
+			std::rethrow_exception(error);
+	}
+	for (size_t i = 0; i < pairs; ++i) {
+		tmp.insert(tmp.end(), outs[i].begin(), outs[i].end());
+		compared += counts[i];
+		if (found[i])
+			find = true;
+	}
+	return find;
 }
 
 /**
-Создает разбиение входных наборов (из is) на группы по их весам. Данные записывает в поле groups \n
-Сложность \f$O(k + n)\f$, где \f$k\f$ - количество единиц функции, \f$n\f$ - количество переменных функции
+Создает разбиение входных наборов (из is) на группы по их весам, а внутри групп -
+на корзины по маскам. Данные записывает в поле groups \n
+Сложность \f$O(k \cdot log(k))\f$, где \f$k\f$ - количество единиц функции
 \param[in]		is			Наборы для разбиения
 */
 auto Quine_McCluskey_Simplifier::create_groups(decltype(input_sets_)& is) -> void {
 	// количество единиц = k
-	for (auto i : is) {
-		// get_weight = O(n)
-		groups_[get_weight(i)].push_back(make_pair(i, false));
+	for (const auto& i : is) {
+		// weight = O(1)
+		groups_[i.weight()].push_back(std::make_pair(i, false));
+	}
+	for (auto& group : groups_) {
+		std::stable_sort(group.begin(), group.end(), [](const std::pair<cube, bool>& x, const std::pair<cube, bool>& y) {
+			return std::get<0>(x).mask_less(std::get<0>(y));
+		});
 	}
 }
 
 /**
 Создает таблицу покрытия единиц импликантами, которые были переданы функции \n
-Сложность \f$O(k \cdot n^3)\f$, где \f$k\f$ - количество еще не покрытых единиц функции, 
+Сложность \f$O(k \cdot n)\f$, где \f$k\f$ - количество еще не покрытых единиц функции, 
 \f$n\f$ - количество импликант, которые рассматриваются
 \param[in]		ones			Единицы для покрытия
 \param[in]		impls			Импликанты для покрытия
 */
 auto Quine_McCluskey_Simplifier::create_table(const decltype(input_sets_)& ones, const decltype(input_sets_)& impls) -> void {
 	// Cоздаем таблицу покрытия импликантами единиц функции.
-	table_.resize(ones.size()); // O(k)
-	for (auto i : table_)
-		std::get<0>(i).resize(impls.size()); // O(k * n)
-	for (auto i = 0; i < ones.size(); ++i) { // k *
-		for (auto j = 0; j < impls.size(); ++j) { // n *
-			if (is_cover(ones[i], impls[j])) { // n
-				std::get<0>(table_[i]).push_back(1);
-			}
-			else {
-				std::get<0>(table_[i]).push_back(0);
-			}
-		}
-	}
-}
-
-/**
-Посредством сложных (на самом деле, не очень) махинаций, находит индекс того импликанта, который
-обеспечивает максимальное покрытие таблицы \n
-Сложность \f$O(n)\f$, где \f$n\f$ - размер вектора
-\param[in]		vect			Вектор, в котором ищем максимальное покрытие
-\params[out]	ind				Индекс импликанта, обеспечивающего максимальное покрытие
-*/
-auto Quine_McCluskey_Simplifier::find_max_cover_ind(const std::vector<std::size_t>& vect) const -> size_t {
-	size_t ind = 0;
-	for (auto i = 0; i < vect.size(); ++i)
-		if (vect[i] > vect[ind])
-			ind = i;
-	return ind;
+	table_ = cover_matrix(ones.size(), impls.size()); // O(k * n / 64)
+	for (size_t i = 0; i < ones.size(); ++i) // k *
+		for (size_t j = 0; j < impls.size(); ++j) // n *
+			if (impls[j].covers(ones[i])) // O(1)
+				table_.set(i, j);
 }
 
 /**
-Вычисляет ядро функции. Неочевидно, но возвращает те наборы, которые не покрыты ядром \n
-Сложность \f$O(k \cdot n \cdot m^2)\f$, где \f$k\f$ - количество единиц функции,
-\f$n\f$ - количество переменных функции, 
-\f$m\f$ - количество импликант
+Вычисляет ядро функции. Неочевидно, но возвращает те наборы, которые не покрыты ядром.
+Набор, который покрыт единственным импликантом (одна единица в строке таблицы),
+вносит этот импликант в ядро \n
+Сложность \f$O(k \cdot m / 64 + s)\f$, где \f$k\f$ - количество единиц функции,
+\f$m\f$ - количество импликант, \f$s\f$ - количество единиц в столбцах ядра
 \param[out]		not_covered_ones	Наборы, которые не покрыты ядром
 */
-auto Quine_McCluskey_Simplifier::get_func_core() -> std::vector<std::string> {
-	std::vector<std::string> to_choice;
-	std::vector<std::string> not_covered_ones;
-	for (auto i = 0; i < table_.size(); ++i) { // O(k) - количество единиц
-		if (is_prime(std::get<0>(table_[i]))) { // O(n) - количество переменных
-			for (auto j = 0; j < std::get<0>(table_[i]).size(); ++j) { // O(m) - колиество импликант
-				if (std::get<0>(table_[i])[j] == 1) {
-					if (!in_vect(prime_, implicants_[j])) { // O(m)
-						prime_.push_back(implicants_[j]);
-					}
-					std::get<1>(table_[i]) = true;
-					for (auto k = 0; k < input_sets_.size(); ++k) { // O(k)
-						if (std::get<0>(table_[k])[j] == 1)
-							std::get<1>(table_[k]) = true;
-					}
-					break;
-				}
+auto Quine_McCluskey_Simplifier::get_func_core() -> std::vector<cube> {
+	std::vector<cube> not_covered_ones;
+	std::vector<char> covered(table_.rows(), 0);
+	cube_set in_core(prime_.begin(), prime_.end());
+	for (size_t i = 0; i < table_.rows(); ++i) { // O(k) - количество единиц
+		if (table_.row_count(i) == 1) { // O(m / 64)
+			const auto j = table_.first_in_row(i);
+			if (in_core.insert(implicants_[j])) { // O(1)
+				prime_.push_back(implicants_[j]);
+				table_.for_each_in_col(j, [&covered](size_t k) { covered[k] = 1; });
 			}
 		}
 	}
-	for (auto i = 0; i < table_.size(); ++i) { // O(k)
-		if (std::get<1>(table_[i]) == false) {
+	for (size_t i = 0; i < table_.rows(); ++i) { // O(k)
+		if (!covered[i]) {
 			not_covered_ones.push_back(input_sets_[i]);
 		}
 	}
@@ -215,84 +254,140 @@ auto Quine_McCluskey_Simplifier::get_func_core() -> std::vector<std::string> {
 	return not_covered_ones;
 }
 
+/**
+Заменяет get_implicants, create_table и get_func_core без склейки и без таблицы всех
+простых импликант. По единицам (L) и единицам с неопределенными наборами (U) строятся
+диаграммы решений, по U - ZDD всех простых импликант (метод Кудера-Мадра). Импликанты
+перебираются из ZDD по одной, не запоминаясь:
+- импликант p существенный, если у него есть единица m, которую не покрывает никакой
+другой простой импликант. Другой импликант покрывает m тогда и только тогда, когда
+для какой-то заданной в p переменной набор m с ее измененным значением лежит в U, т.е.
+p существенный, если L|p * !(U|p1 + ... + U|pj) != 0, где pi - p с i-м литералом,
+замененным на противоположный. Существенные импликанты записываются в prime_;
+- затем в implicants_ выписываются только импликанты, пересекающиеся с единицами,
+которые ядро не покрыло (R = L * !ядро), т.е. столбцы циклической части таблицы.
+Узлы, созданные для проверки импликантов, периодически убираются (bdd::collect), так что
+память зависит от размеров диаграмм и этой части таблицы, а не от количества всех
+простых импликант \n
+Сложность \f$O(k \cdot n)\f$ на построение диаграмм и \f$O(p \cdot n \cdot |U|)\f$ на два
+прохода по \f$p\f$ простым импликантам
+\param[in]		limit		Наибольшее количество импликант в implicants_
+\param[in]		stats		Куда записать количество простых импликант и время поиска ядра
+\param[out]	not_covered_ones	Единицы, которые не покрыты ядром
+\throw			logic_error	Исключение, если импликант для таблицы покрытия больше limit
+*/
+auto Quine_McCluskey_Simplifier::get_implicants_implicit(const size_t limit, simplify_stats& stats) -> std::vector<cube> {
+	bdd manager(vars_);
+	std::vector<size_t> roots(2);
+	auto& ones = roots[0];
+	auto& upper = roots[1];
+	ones = manager.from_cubes(input_sets_);
+	upper = manager.disj(ones, manager.from_cubes(dont_cares_));
+	zdd family;
+	const auto primes = family.primes(manager, upper);
+	stats.primes = family.count(primes);
+
+	// Кофакторы и дизъюнкции одного импликанта после его проверки не нужны. Чтобы память
+	// не росла с количеством импликант, когда узлов становится вдвое больше, чем после
+	// прошлой сборки, остаются только узлы диаграмм, нужных дальше
+	auto live = manager.size();
+	const auto tidy = [&manager, &live](std::vector<size_t>& keep) {
+		if (manager.size() > 2 * live + (1 << 16)) {
+			manager.collect(keep);
+			live = manager.size();
+		}
+	};
+	const auto start = std::chrono::steady_clock::now();
+	const auto all = vars_ >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << vars_) - 1;
+	family.for_each(primes, vars_, [&](const cube& p) {
+		tidy(roots);
+		const auto own = manager.cofactor(ones, p);
+		if (own == bdd::zero)
+			return;
+		auto others = static_cast<size_t>(bdd::zero);
+		for (auto fixed = ~p.mask(0) & all; fixed != 0; fixed &= fixed - 1) {
+			const auto bit = fixed & (~fixed + 1);
+			others = manager.disj(others, manager.cofactor(upper, cube(p.value(0) ^ bit, p.mask(0))));
+		}
+		if (manager.conj(own, manager.negate(others)) != bdd::zero)
+			prime_.push_back(p);
+	});
+	std::vector<size_t> left(1, manager.conj(ones, manager.negate(manager.from_cubes(prime_))));
+	auto& rest = left[0];
+	std::vector<cube> not_covered_ones;
+	if (rest != bdd::zero) {
+		// Импликанты ядра попадают сюда сами собой: все их единицы уже покрыты
+		family.for_each(primes, vars_, [&](const cube& p) {
+			tidy(left);
+			if (manager.cofactor(rest, p) == bdd::zero)
+				return;
+			if (implicants_.size() >= limit)
+				throw std::logic_error("Too many prime implicants.");
+			implicants_.push_back(p);
+		});
+		for (const auto& i : input_sets_)
+			if (manager.value(rest, i.value(0)))
+				not_covered_ones.push_back(i);
+	}
+	stats.core_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return not_covered_ones;
+}
+
 /**
 Находит все простые импликанты функции, записывает их в поле implicants.
-В функции используется лямбда:
-\code
-auto find_index = [this](auto x, auto y) { for (size_t i = 0; i < x.size(); ++i)
-if (x[i] != y[i])
-return i;
-};
-\endcode
-Эта функция находит индекс, который нужно изменить с '0' или '1' на '-'.
-Проще говоря, нужна для склейки \n
-Сложность (это не точно, это оценка) \f$O(log(k) \cdot (k \cdot n^3))\f$, где 
+Склеиваются и единицы функции, и неопределенные наборы (dont_cares), но в таблицу
+покрытия (create_table) попадают только единицы.
+Соседство и склейка наборов - побитовые операции над кубами (XOR и подсчет единиц).
+Один и тот же куб получается склейкой нескольких пар (например, 1-0- из 100-
+и 110- или из 1-00 и 1-01), поэтому повторы отбрасываются сразу при склейке,
+и в следующий раунд попадают только различные импликанты \n
+Сложность (это не точно, это оценка) \f$O(log(k) \cdot (k \cdot n^2))\f$, где 
 \f$k\f$ - количество значимых единиц функции, \f$n\f$ - количество переменных функции
+\param[in]		stats		Куда записать количество раундов, кубов и сравнений (может быть nullptr)
 */
-auto Quine_McCluskey_Simplifier::get_implicants() -> void {
-	auto find_index = [this](auto x, auto y) { for (size_t i = 0; i < x.size(); ++i)
-		if (x[i] != y[i])
-			return i;
-	}; // O(n)
-	create_groups(input_sets_);
-	std::vector<std::string> tmp;
+auto Quine_McCluskey_Simplifier::get_implicants(simplify_stats* stats) -> void {
+	// Неопределенные наборы участвуют в склейке наравне с единицами
+	auto sets = input_sets_;
+	sets.insert(sets.end(), dont_cares_.begin(), dont_cares_.end());
+	create_groups(sets);
+	std::vector<cube> tmp;
+	cube_set found(implicants_.begin(), implicants_.end());
 	auto find = true;
+	size_t compared = 0;
 	// Пока находятся скейки
 	// Вероятно, O(log(k))
 	while (find) {
-		find = false;
-		// Цикл по всей таблице
-		for (auto i = 0; i < groups_.size() - 1; ++i) { // Количество значимых единиц
-			// Цикл по строке таблице
-			for (auto j = 0; j < groups_[i].size(); ++j) { // Количество переменных
-				// Цикл сравнения со всеми соседями
-				for (auto k = 0; k < groups_[i + 1].size(); ++k) { // Еще раз количество перменнных
-					if (is_neighbors(std::get<0>(groups_[i][j]), std::get<0>(groups_[i + 1][k]))) {
-						auto ind = find_index(std::get<0>(groups_[i][j]), std::get<0>(groups_[i + 1][k])); // Еще раз количество перменных
-						std::get<1>(groups_[i][j]) = true;
-						std::get<1>(groups_[i + 1][k]) = true;
-						auto str = std::get<0>(groups_[i][j]);
-						str[ind] = '-';
-						tmp.push_back(str);
-						find = true;
-					}
-				}
-			}
-		} // O(k \cdot n^3)
+		if (stats) {
+			size_t cubes = 0;
+			for (const auto& group : groups_)
+				cubes += group.size();
+			stats->cubes_per_round.push_back(cubes);
+		}
+		// Цикл по всей таблице: склеиваем соседние группы
+		find = combine_round(tmp, compared); // O(k \cdot n^2)
 		for (auto i = 0; i < groups_.size(); ++i) {
 			for (auto j = 0; j < groups_[i].size(); ++j) {
 				if (std::get<1>(groups_[i][j]) == false) {
-					if (!in_vect(implicants_, std::get<0>(groups_[i][j]))) {
+					if (found.insert(std::get<0>(groups_[i][j]))) {
 						implicants_.push_back(std::get<0>(groups_[i][j]));
 					}
 				}
 			}
 		}
-		groups_.clear(); // O(n)
-		groups_.resize(num_of_vars() + 1); // O(n + 1)
+		clear_groups(); // O(n)
 		create_groups(tmp); // O(n + k)
 		tmp.clear(); // O(n)
 	}
-}
-
-/**
-Возвращает вес набора - количество единиц в нем \n
-Сложность \f$O(n)\f$, где \f$n\f$ - количество переменных функции
-\param[in]		set			Набор для вычисления веса
-\param[out]		weight		Количество единиц в наборе
-*/
-auto Quine_McCluskey_Simplifier::get_weight(const std::string& set) const -> size_t {
-	auto weight = 0;
-	for (auto i : set)
-		if (i == '1')
-			++weight;
-	return weight;
+	if (stats) {
+		stats->rounds = stats->cubes_per_round.size();
+		stats->comparisons = compared;
+	}
 }
 
 /**
 Возвращает строку, которая содержит представление полученной МДНФ в формульном виде \n
 Сложность \f$O(n)\f$, где \f$n\f$ - количество переменных функции
-\param[in]		impl			Набор, который нужно перевести в формулу
+\param[in]		impl			Импликант строкой из '0', '1' и '-', который нужно перевести в формулу
 \param[out]		res				Строка-формула
 */
 auto Quine_McCluskey_Simplifier::impl_to_formula(const std::string & impl) const -> std::string {
@@ -309,98 +404,38 @@ auto Quine_McCluskey_Simplifier::impl_to_formula(const std::string & impl) const
 }
 
 /**
-Проверяет наличие элемента в векторе \n
-Сложность \f$O(n)\f$, где \f$n\f$ - длина вектора
-\param[in]		vect		Вектор для проверки
-\param[in]		s			Элемент, наличие которого нужно проверить
-\param[out]		true/false	Если элемент найден, то true; иначе false
-*/
-auto Quine_McCluskey_Simplifier::in_vect(const std::vector<std::string>& vec, const std::string & s) const -> bool {
-	for (const auto i : vec)
-		if (i == s)
-			return true;
-	return false;
-}
-
-/**
-Аналогичная функция, но проверяет для вектора пар (std::vector<std::pair<>>) \n
-Сложность \f$O(n)\f$, где \f$n\f$ - длина вектора
-\param[in]		vect		Вектор для проверки
-\param[in]		s			Элемент, наличие которого нужно проверить
-\param[out]		true/false	Если элемент найден, то true; иначе false
-*/
-auto Quine_McCluskey_Simplifier::in_vect(const std::vector<std::pair<std::string, size_t>>& vec, const std::string & s) const -> bool {
-	for (auto i : vec)
-		if (std::get<0>(i) == s)
-			return true;
-	return false;
-}
-
-/**
-Проверяет, покрывает ли второй набор первый \n
-Сложность \f$O(n)\f$, где \f$n\f$ - количество переменных функции
-\param[in]		first		Первый набор
-\param[in]		second		Второй набор
-\param[out]		true/false	Если набор second покрывает набор first возвращает true;
-иначе false
-*/
-auto Quine_McCluskey_Simplifier::is_cover(const std::string & first, const std::string & second) const -> bool {
-	for (auto i = 0; i < first.size(); ++i)
-		if (first[i] != second[i] && second[i] != '-')
-			return false;
-	return true;
-}
-
-/**
-Соседние ли наборы? Нужна для попарного сравнения в группах \n
-Сложность \f$O(n)\f$, где \f$n\f$ - количество переменных функции
-\param[in]		first		Первый набор
-\param[in]		second		Второй набор
-\param[out]		true/false	Если наборы соседние (различаются в одной координате),
-то возвращает true; иначе false
-*/
-auto Quine_McCluskey_Simplifier::is_neighbors(const std::string& first, const std::string& second) const -> bool {
-	size_t k = 0;
-	for (auto i = 0; i < first.size(); ++i) {
-		if (first[i] != second[i])
-			++k;
-		if (k > 1)
-			return false;
-	}
-	return true;
-}
-
-/**
-Проверяет, входит ли импликант в ядро функции. Если единица нашлась только одна, то вывод: эту единицу
-может покрыть только этот импликант и следует внести его в ядро \n
-Сложность \f$O(n)\f$, где \f$n\f$ - количество переменных функции
-\param[in]		x			Вектор для проверки
-\param[out]		true/false	Если единица в векторе только одна, возвращает true;
-иначе false
+Импликанты полученной МДНФ строками из '0', '1' и '-' в порядке вывода
+(для функций больше чем от 64 переменных - из wide_mdnf) \n
+Сложность \f$O(n \cdot m)\f$, где \f$n\f$ - количество переменных, \f$m\f$ - количество импликант МДНФ
 */
-auto Quine_McCluskey_Simplifier::is_prime(const std::vector<size_t>& x) const -> bool {
-	auto k = 0;
-	for (auto i : x) {
-		if (i == 1)
-			++k;
-		if (k > 1)
-			return false;
-	}
-	return true;
+auto Quine_McCluskey_Simplifier::mdnf_strings() const -> std::vector<std::string> {
+	std::vector<std::string> res;
+	if (wide())
+		for (const auto& i : wide_mdnf_)
+			res.push_back(i.to_string(vars_));
+	else
+		for (const auto& i : mdnf_)
+			res.push_back(i.to_string(vars_));
+	return res;
 }
 
 /**
 Возвращает количество переменных рассматриваемой функции \n
-Сложность \f$O(k)\f$, где \f$k\f$ - количество значимых единиц функции
-\param[out]		k			Рассматривает максимальную длину строки (строки хранят
-наборы), она и будет количеством переменных функции
+Сложность \f$O(k + d)\f$, где \f$k\f$ - количество значимых единиц функции,
+\f$d\f$ - количество неопределенных наборов
+\param[out]		k			Длина двоичной записи наибольшего набора, она и будет
+количеством переменных функции (набор 0 записывается одной цифрой)
 */
 auto Quine_McCluskey_Simplifier::num_of_vars() const -> size_t {
-	auto k = 0;
-	for (auto i = 0; i < input_sets_.size(); ++i)
-		if (input_sets_[i].length() > k)
-			k = input_sets_[i].size();
-	return k;
+	if (input_sets_.empty() && dont_cares_.empty())
+		return 0;
+	// Старший бит у объединения наборов тот же, что и у наибольшего из них
+	std::uint64_t all = 0;
+	for (const auto& i : input_sets_)
+		all |= i.value(0);
+	for (const auto& i : dont_cares_)
+		all |= i.value(0);
+	return all != 0 ? bits::highest(all) + 1 : 1;
 }
 
 /**
@@ -409,9 +444,10 @@ auto Quine_McCluskey_Simplifier::num_of_vars() const -> size_t {
 \throw	logic_error	Кидает исключение, если минимизация не была произведена, а функция была вызвана
 */
 auto Quine_McCluskey_Simplifier::print_mdnf(std::ostream& os) const -> void {
-	if (mdnf_.size() == 0)
+	const auto terms = mdnf_strings();
+	if (terms.size() == 0)
 		throw std::logic_error("Minimization was not carried out");
-	for (const auto i : mdnf_) {
+	for (const auto& i : terms) {
 		os << i << " ";
 	}
 }
@@ -423,10 +459,11 @@ auto Quine_McCluskey_Simplifier::print_mdnf(std::ostream& os) const -> void {
 \throw	logic_error	Кидает исключение, если минимизация не была произведена, а функция была вызвана
 */
 auto Quine_McCluskey_Simplifier::print_mdnf(const std::string & file_name) const -> void {
-	if (mdnf_.size() == 0)
+	const auto terms = mdnf_strings();
+	if (terms.size() == 0)
 		throw std::logic_error("Minimization was not carried out");
 	std::ofstream output(file_name);
-	for (const auto i : mdnf_) {
+	for (const auto& i : terms) {
 		output << i << " ";
 	}
 	output.close();
@@ -434,119 +471,505 @@ auto Quine_McCluskey_Simplifier::print_mdnf(const std::string & file_name) const
 
 /**
 Функция-инициализатор объекта. Инциализирует объект по потоку. Если sets установлен в true,
-то инциализирует по номерам наборов, в которых функция равна единице (в десятичном виде)
-По своей сути аналогичек конструктору по потоку\n
-Сложность \f$O(2^m + n)\f$, где \f$m\f$ - длина регулярного выражения, 
-\f$n\f$ - длина входной строки
+то инциализирует по номерам наборов, в которых функция равна единице (в десятичном виде).
+Номера после "d" и до конца строки - наборы, на которых значение функции не определено,
+например "1 4 10 d 2 3". Если sets установлен в false, то ожидается вектор значений,
+где '-' - неопределенное значение
+По своей сути аналогичек конструктору по потоку. Предыдущая функция заменяется, а память
+под наборы и группы переиспользуется\n
+Номера наборов читаются целиком, а не построчно (см. load_sets) \n
+Сложность \f$O(n)\f$, где \f$n\f$ - длина входной строки
 \param[in] file_name	Имя выходного файла
 \param[in] sets			По номерам наборов или нет?
 \throw	logic_error	Исключение, если размер вектора не является степенью двойки
+\throw	logic_error	Исключение, если номер набора не помещается в 128 бит
 */
 auto Quine_McCluskey_Simplifier::init(std::istream& is, bool sets) -> void {
-	if (sets == false) {
-		*this = Quine_McCluskey_Simplifier(is);
+	if (sets) {
+		const std::string text((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+		load_sets(text.data(), text.data() + text.size());
 		return;
 	}
-	std::string temp; // O(1)
-	std::smatch m; // O(1)
-	std::regex e("[[:digit:]]+"); // O(1)?
+	std::string temp;
+	std::vector<std::uint64_t> ones, dont_cares;
 	while (is.good()) {
 		getline(is, temp);
-		while (std::regex_search(temp, m, e)) { // O(n)?
-			for (auto x : m)
-				if (!in_vect(input_sets_, string_base10_to_base2(x)))
-					input_sets_.push_back(string_base10_to_base2(x)); // O(1)
-			temp = m.suffix().str();
-		}
+		parse_vector(temp.data(), temp.data() + temp.size(), ones, dont_cares);
 	}
-	
-	const size_t m_l = num_of_vars();
-	groups_.resize(m_l + 1);
-	for (auto i = 0; i < input_sets_.size(); ++i) {
-		align(i, m_l);
+	input_sets_.clear();
+	dont_cares_.clear();
+	add_minterms(ones, dont_cares);
+	prepare();
+}
+
+/**
+Функция-инициализатор объекта по файлу. Формат тот же, что и у init по потоку, и ошибки те же,
+но файл не читается построчно в строки: он отображается в память и разбирается на месте,
+так что вектор значений из 2^24 символов не копируется (см. mapped_file). Предыдущая функция заменяется \n
+Сложность \f$O(n)\f$, где \f$n\f$ - размер файла
+\param[in] file_name	Имя входного файла
+\param[in] sets			По номерам наборов или нет?
+\throw	logic_error	Исключение, если файл не был открыт
+\throw	logic_error	Исключение, если размер вектора не является степенью двойки
+\throw	logic_error	Исключение, если номер набора не помещается в 128 бит
+*/
+auto Quine_McCluskey_Simplifier::init(const std::string& file_name, bool sets) -> void {
+	const mapped_file input(file_name);
+	if (sets) {
+		load_sets(input.begin(), input.end());
+		return;
 	}
+	std::vector<std::uint64_t> ones, dont_cares;
+	parse_vector(input.begin(), input.end(), ones, dont_cares);
+	input_sets_.clear();
+	dont_cares_.clear();
+	add_minterms(ones, dont_cares);
+	prepare();
 }
 
 /**
-Главная функция доступа извне - создает внутри класса МДНФ \n
-Сложность \f$O(log(k) \cdot (k \cdot n^3) + k \cdot n \cdot m^2 + k \cdot n^3 + k^2)\f$, где 
-\f$k\f$ - количество единиц функции, \f$n\f$ - количество переменных, \f$m\f$ - количество импликант
+Функция-инициализатор объекта по номерам наборов, заданным числами: единицы функции и
+неопределенные наборы. Предыдущая функция заменяется. Так, например, формула передается
+без построения вектора значений: QMS.init(log_expr(formula).minterms()).
+Количество переменных - наибольшее из vars и нужного для записи наибольшего номера, так что
+переменные, которые ни в одной единице не равны единице, не теряются \n
+Сложность \f$O(k + d)\f$, где \f$k\f$ - количество единиц функции, \f$d\f$ - количество неопределенных наборов
+\param[in] ones			Номера наборов, на которых функция равна единице
+\param[in] dont_cares	Номера наборов, на которых значение функции не определено
+\param[in] vars			Количество переменных (0 - по наибольшему номеру)
+\throw		logic_error	Исключение, если vars больше 64
 */
-auto Quine_McCluskey_Simplifier::simplify() -> void {
-	get_implicants(); // O(log(k) * (k * n^3))
-	create_table(input_sets_, implicants_); // O(k * n^3)
-	auto not_covered_ones = get_func_core(); // O(k * n * m^2)
-	table_.clear(); // O(k * m)
-	std::vector<std::string> not_prime_implicants;
-	std::vector<size_t> every_impl_covers;
-	for (const auto i : implicants_) { // O(m)
-		if (!in_vect(prime_, i)) {
-			not_prime_implicants.push_back(i);
-			every_impl_covers.push_back(0);
-		}
+auto Quine_McCluskey_Simplifier::init(const std::vector<std::uint64_t>& ones, const std::vector<std::uint64_t>& dont_cares, const size_t vars) -> void {
+	if (vars > 64)
+		throw std::logic_error("Too many variables.");
+	input_sets_.clear();
+	dont_cares_.clear();
+	add_minterms(ones, dont_cares);
+	prepare(vars);
+}
+
+/**
+Функция-инициализатор объекта по покрытию кубами (например, bdd::prime_cover). Наборы
+не перебираются, поэтому так задаются функции с огромным количеством единиц, но минимизировать
+их можно только эвристикой Espresso (options.engine == e_espresso). Предыдущая функция заменяется \n
+Сложность \f$O(c)\f$, где \f$c\f$ - количество кубов
+\param[in] ones			Кубы, объединение которых - единицы функции
+\param[in] vars			Количество переменных
+\throw		logic_error	Исключение, если vars больше 64
+*/
+auto Quine_McCluskey_Simplifier::init_cubes(const std::vector<cube>& ones, const size_t vars) -> void {
+	if (vars > cube::max_vars)
+		throw std::logic_error("Too many variables.");
+	clear_wide();
+	input_sets_ = ones;
+	dont_cares_.clear();
+	vars_ = vars;
+	clear_groups();
+	cube_input_ = true;
+}
+
+/**
+Дописывает наборы, заданные числами, в input_sets и dont_cares, пропуская повторы \n
+Сложность \f$O(k + d)\f$, где \f$k\f$ - количество единиц функции, \f$d\f$ - количество неопределенных наборов
+\param[in] ones			Номера наборов, на которых функция равна единице
+\param[in] dont_cares	Номера наборов, на которых значение функции не определено
+*/
+auto Quine_McCluskey_Simplifier::add_minterms(const std::vector<std::uint64_t>& ones, const std::vector<std::uint64_t>& dont_cares) -> void {
+	cube_set seen(input_sets_.begin(), input_sets_.end());
+	cube_set seen_dc(dont_cares_.begin(), dont_cares_.end());
+	seen.reserve(input_sets_.size() + ones.size());
+	input_sets_.reserve(input_sets_.size() + ones.size());
+	for (const auto i : ones)
+		if (seen.insert(cube(i)))
+			input_sets_.push_back(cube(i));
+	for (const auto i : dont_cares)
+		if (seen_dc.insert(cube(i)))
+			dont_cares_.push_back(cube(i));
+}
+
+/**
+Разбирает номера наборов в буфере [first, last) - строке из потока или отображенном файле.
+Номера после "d" и до конца строки попадают в dont_cares (см. set_tokenizer) \n
+Сложность \f$O(n)\f$, где \f$n\f$ - длина буфера
+\param[in] first			Начало буфера
+\param[in] last			Конец буфера
+\param[in] ones			Куда дописывать номера единиц
+\param[in] dont_cares	Куда дописывать номера неопределенных наборов
+*/
+auto Quine_McCluskey_Simplifier::parse_sets(const char* first, const char* last,
+	std::vector<std::uint64_t>& ones, std::vector<std::uint64_t>& dont_cares) const -> void {
+	set_tokenizer tokens(first, last);
+	std::uint64_t set;
+	while (tokens.next(set)) // O(n)
+		(tokens.dont_care() ? dont_cares : ones).push_back(set); // O(1)
+}
+
+/**
+Загружает функцию по номерам наборов в буфере [first, last), заменяя предыдущую.
+Если какой-то номер не помещается в 64 бита, у функции больше 64 переменных: буфер
+разбирается заново в wide_cube (load_wide_sets) \n
+Сложность \f$O(n)\f$, где \f$n\f$ - длина буфера
+\throw	logic_error	Исключение, если номер набора не помещается в 128 бит
+*/
+auto Quine_McCluskey_Simplifier::load_sets(const char* first, const char* last) -> void {
+	std::vector<std::uint64_t> ones, dont_cares;
+	try {
+		parse_sets(first, last, ones, dont_cares);
+	}
+	catch (const std::logic_error&) {
+		load_wide_sets(first, last);
+		return;
 	}
+	input_sets_.clear();
+	dont_cares_.clear();
+	add_minterms(ones, dont_cares);
+	prepare();
+}
 
-	// Новая таблица - таблица непокрытых единиц и всех импликант, 
-	// не вошедших в ядро.
-	create_table(not_covered_ones, not_prime_implicants); // O(k * n^3)
-
-	std::vector<std::vector<bool>> covering;
-	std::vector<std::string> simple_cover;
-
-	//is_cover(not_prime_implicants[j], not_covered_ones[j])
-	std::vector<std::string> final_cover;
-	while (not_covered_ones.size() != 0) {
-		// Проходим по наборам, на которых функция равна 1
-		for (auto i = 0; i < table_.size(); ++i) { // O(k)
-			// Теперь - по импликантам
-			for (auto j = 0; j < std::get<0>(table_[i]).size(); ++j) { // O(m)
-				if (std::get<0>(table_[i])[j] == 1) {
-					++every_impl_covers[j];
-				}
-			}
-		}
+/**
+Загружает функцию больше чем от 64 переменных: номера наборов читаются в wide_cube,
+повторы пропускаются, наборы, на которых функция задана единицей, из неопределенных
+убираются. Количество переменных - длина двоичной записи наибольшего номера \n
+Сложность \f$O(n)\f$, где \f$n\f$ - длина буфера
+\throw	logic_error	Исключение, если номер набора не помещается в 128 бит
+*/
+auto Quine_McCluskey_Simplifier::load_wide_sets(const char* first, const char* last) -> void {
+	clear_wide();
+	set_tokenizer tokens(first, last);
+	std::uint64_t words[wide_cube::words];
+	const std::uint64_t none[wide_cube::words] = {};
+	basic_cube_set<wide_cube> seen, seen_dc;
+	size_t vars = 0;
+	while (tokens.next(words, wide_cube::words)) {
+		const auto set = wide_cube::from_words(words, none);
+		vars = std::max(vars, set.bit_length());
+		if (!tokens.dont_care() && seen.insert(set))
+			wide_ones_.push_back(set);
+		else if (tokens.dont_care() && seen_dc.insert(set))
+			wide_dont_cares_.push_back(set);
+	}
+	wide_dont_cares_.erase(std::remove_if(wide_dont_cares_.begin(), wide_dont_cares_.end(),
+		[&seen](const wide_cube& x) { return seen.contains(x); }), wide_dont_cares_.end());
+	input_sets_.clear();
+	dont_cares_.clear();
+	vars_ = vars;
+	cube_input_ = false;
+}
 
-		const auto ind = find_max_cover_ind(every_impl_covers); // O(m)
-		if (ind < not_prime_implicants.size()) {
-			final_cover.push_back(not_prime_implicants[ind]);
+/**
+Освобождает функцию больше чем от 64 переменных (перед загрузкой новой функции) \n
+Сложность \f$O(k)\f$, где \f$k\f$ - количество ее наборов
+*/
+auto Quine_McCluskey_Simplifier::clear_wide() -> void {
+	wide_ones_.clear();
+	wide_dont_cares_.clear();
+	wide_mdnf_.clear();
+}
 
-			for (auto i = 0; i < table_.size(); ++i) { // O(k)
-				for (auto j = 0; j < table_.size(); ++j) { // O(k)
-					if (std::get<0>(table_[i])[ind] == 1) {
-						std::get<1>(table_[i]) = true;
-					}
-				}
-			}
-			every_impl_covers.clear(); // O(m)
-			decltype(not_prime_implicants) tmp;
-			for (const auto i : not_prime_implicants) { // O(m)
-				if (!in_vect(final_cover, i)) {
-					tmp.push_back(i);
-					every_impl_covers.push_back(0);
-				}
-			}
-			not_prime_implicants = tmp;
-			tmp.clear();
-			for (auto i = 0; i < not_covered_ones.size(); ++i) { // O(k)
-				if (std::get<1>(table_[i]) == false)
-					tmp.push_back(not_covered_ones[i]);
-			}
-			not_covered_ones = tmp;
-			tmp.clear();
-			table_.clear();
+/**
+Разбирает вектор значений в буфере [first, last) - строке из потока или отображенном файле.
+Каждая строка проверяется отдельно и задает всю функцию, как и в конструкторе по потоку \n
+Сложность \f$O(n + k)\f$, где \f$n\f$ - длина буфера, \f$k\f$ - количество значимых единиц функции
+\param[in] first			Начало буфера
+\param[in] last			Конец буфера
+\param[in] ones			Куда дописывать номера единиц
+\param[in] dont_cares	Куда дописывать номера неопределенных наборов
+\throw	logic_error	Исключение, если размер вектора не является степенью двойки
+\throw	logic_error	Исключение, если встретились символы, отличные от "0", "1" и "-"
+*/
+auto Quine_McCluskey_Simplifier::parse_vector(const char* first, const char* last,
+	std::vector<std::uint64_t>& ones, std::vector<std::uint64_t>& dont_cares) const -> void {
+	while (true) {
+		const auto end = std::find(first, last, '\n');
+		const auto size = static_cast<size_t>(end - first);
+		if (!((size == 0) ? 0 : (size & (size - 1)) == 0))
+			throw std::logic_error("Size of vector is invalid. Check your input.");
+		if (!vector_scan::scan(first, size, 0, ones, dont_cares))
+			throw std::logic_error("Incorrect input.");
+		if (end == last)
+			break;
+		first = end + 1;
+	}
+}
+
+/**
+Завершает загрузку: убирает из dont_cares наборы, на которых функция задана единицей,
+определяет количество переменных (не меньше vars) и готовит группы \n
+Сложность \f$O(k + d)\f$, где \f$k\f$ - количество единиц функции, \f$d\f$ - количество неопределенных наборов
+\param[in] vars			Наименьшее количество переменных
+*/
+auto Quine_McCluskey_Simplifier::prepare(const size_t vars) -> void {
+	clear_wide();
+	const cube_set ones(input_sets_.begin(), input_sets_.end());
+	dont_cares_.erase(std::remove_if(dont_cares_.begin(), dont_cares_.end(),
+		[&ones](const cube& x) { return ones.contains(x); }), dont_cares_.end());
+	vars_ = std::max(num_of_vars(), vars);
+	clear_groups();
+	cube_input_ = false;
+}
 
-			create_table(not_covered_ones, not_prime_implicants);
+/**
+Очищает группы и оставляет их vars + 1 штук. Сами векторы групп не освобождаются,
+так что следующий раунд склейки (или следующая функция) пишет в уже выделенную память \n
+Сложность \f$O(n)\f$, где \f$n\f$ - количество переменных функции
+*/
+auto Quine_McCluskey_Simplifier::clear_groups() -> void {
+	for (auto& group : groups_)
+		group.clear();
+	groups_.resize(vars_ + 1);
+}
+
+/**
+Задает количество потоков для склейки в get_implicants. 1 (по умолчанию) - последовательная
+склейка, 0 - столько потоков, сколько ядер у процессора. Результат от количества потоков не зависит \n
+Сложность \f$O(1)\f$
+\param[in] threads		Количество потоков
+*/
+auto Quine_McCluskey_Simplifier::set_threads(const size_t threads) -> void {
+	threads_ = threads != 0 ? threads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+/**
+Главная функция доступа извне - создает внутри класса МДНФ. После выделения ядра
+таблица оставшихся наборов сокращается до циклического ядра (если options.reduce),
+и оно покрывается жадно или точно, в зависимости от options.cover.
+Точный выбор ограничен options.node_limit и options.time_limit; если он не успел
+доказать минимальность, используется лучшее из найденных покрытий (не хуже жадного).
+Если задан options.stats, туда записываются времена фаз и счетчики (см. simplify_stats).
+Если options.engine == e_espresso, простые импликанты не перебираются: МДНФ строится
+эвристикой Espresso (см. espresso), что годится и для функций от 40-64 переменных.
+Функции больше чем от 64 переменных (номера наборов больше 64 бит) минимизируются
+только так (см. simplify_wide).
+Если options.engine == e_implicit, простые импликанты строятся по ZDD, и ядро находится
+по диаграммам (get_implicants_implicit) - выписываются только импликанты циклической части
+таблицы, не больше options.prime_limit; дальше все как для e_quine_mccluskey.
+Если задан options.cache, результат сначала ищется в нем (по хэшу наборов и параметров),
+а посчитанный результат туда добавляется (кроме точного выбора покрытия, не доказавшего
+минимальность, см. result_cache::cacheable).
+После init_cubes допустим только options.engine == e_espresso.
+Повторный вызов (в том числе после нового init) считает МДНФ заново \n
+Сложность \f$O(log(k) \cdot (k \cdot n^2) + k \cdot m + s \cdot log(s))\f$, где 
+\f$k\f$ - количество единиц функции, \f$n\f$ - количество переменных, \f$m\f$ - количество импликант,
+\f$s\f$ - количество единиц в таблице покрытия (для жадного выбора)
+\param[in]		options		Параметры минимизации
+\throw			logic_error	Исключение, если функция задана кубами, а способ минимизации - не e_espresso
+\throw			logic_error	Исключение, если у функции больше 64 переменных (см. simplify_wide)
+*/
+auto Quine_McCluskey_Simplifier::simplify(const simplify_options& options) -> void {
+	if (cube_input_ && options.engine != e_espresso)
+		throw std::logic_error("Cube input requires the espresso engine.");
+	if (wide()) {
+		simplify_wide(options);
+		return;
+	}
+	using clock = std::chrono::steady_clock;
+	const auto start = clock::now();
+	auto phase = start;
+	// Время с конца прошлой фазы
+	auto lap = [&phase]() {
+		const auto now = clock::now();
+		const auto res = std::chrono::duration<double, std::milli>(now - phase).count();
+		phase = now;
+		return res;
+	};
+	simplify_stats stats;
+	// Результат предыдущего вызова (или предыдущей функции) не должен попасть в новый
+	implicants_.clear();
+	prime_.clear();
+	mdnf_.clear();
+	clear_groups();
+	if (options.cache) {
+		const auto key = result_cache::key(input_sets_, dont_cares_, vars_, options);
+		simplify_result cached;
+		if (options.cache->find(key, cached) && cached.vars == vars_) {
+			mdnf_.insert(cached.mdnf.begin(), cached.mdnf.end());
+			minimal_ = cached.minimal;
+			if (options.stats) {
+				stats.total_ms = lap();
+				stats.terms = mdnf_.size();
+				*options.stats = stats;
+			}
+			return;
+		}
+		auto uncached = options;
+		uncached.cache = nullptr;
+		simplify(uncached);
+		cached.vars = vars_;
+		cached.mdnf.assign(mdnf_.begin(), mdnf_.end());
+		cached.minimal = minimal_;
+		if (result_cache::cacheable(options, cached))
+			options.cache->insert(key, cached);
+		return;
+	}
+	if (options.engine == e_espresso) {
+		const espresso engine(vars_, dont_cares_);
+		for (const auto& i : engine.minimize(input_sets_))
+			mdnf_.insert(i);
+		minimal_ = false;
+		if (options.stats) {
+			stats.implicants_ms = stats.total_ms = lap();
+			stats.terms = mdnf_.size();
+			*options.stats = stats;
 		}
-		else
-			throw std::logic_error("What?");
+		return;
+	}
+	std::vector<cube> not_covered_ones;
+	if (options.engine == e_implicit) {
+		not_covered_ones = get_implicants_implicit(options.prime_limit, stats);
+		stats.implicants_ms = lap() - stats.core_ms;
+	}
+	else {
+		get_implicants(options.stats ? &stats : nullptr); // O(log(k) * (k * n^2))
+		stats.implicants_ms = lap();
+		create_table(input_sets_, implicants_); // O(k * m)
+		stats.table_ms = lap();
+		not_covered_ones = get_func_core(); // O(k * m / 64)
+		stats.core_ms = lap();
+		table_.clear(); // O(k * m)
+		stats.primes = implicants_.size();
+	}
+	std::vector<cube> not_prime_implicants;
+	const cube_set in_core(prime_.begin(), prime_.end());
+	for (const auto& i : implicants_) { // O(m)
+		if (!in_core.contains(i))
+			not_prime_implicants.push_back(i);
 	}
 
-	for (const auto i : prime_) {
+	// Новая таблица - таблица непокрытых единиц и всех импликант, 
+	// не вошедших в ядро.
+	create_table(not_covered_ones, not_prime_implicants); // O(k * m)
+	stats.table_ms += lap();
+
+	cover_solver solver(table_);
+	std::vector<size_t> chosen;
+	if (options.reduce)
+		chosen = solver.reduce();
+	stats.reduce_ms = lap();
+	stats.core_rows = solver.rows_left();
+	stats.core_cols = solver.cols_left();
+	std::vector<size_t> rest;
+	if (options.cover == c_exact) {
+		rest = solver.exact(options.node_limit, options.time_limit);
+		minimal_ = solver.optimal();
+	}
+	else {
+		rest = solver.greedy(); // O(s * log(s))
+		minimal_ = false;
+	}
+	stats.cover_ms = lap();
+	stats.reduce_picks = chosen.size();
+	stats.cover_picks = rest.size();
+	stats.nodes = solver.nodes();
+	stats.table_rows = table_.rows();
+	stats.table_cols = table_.cols();
+	chosen.insert(chosen.end(), rest.begin(), rest.end());
+	std::vector<cube> final_cover;
+	for (const auto j : chosen)
+		final_cover.push_back(not_prime_implicants[j]);
+	table_.clear();
+
+	for (const auto& i : prime_) {
 		mdnf_.insert(i);
 	}
-	for (const auto i : final_cover) {
+	for (const auto& i : final_cover) {
 		mdnf_.insert(i);
 	}
+	if (options.stats) {
+		stats.essential = prime_.size();
+		stats.terms = mdnf_.size();
+		stats.total_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+		*options.stats = stats;
+	}
+}
+
+/**
+simplify для функций больше чем от 64 переменных: все их наборы и простые импликанты
+не перебрать, поэтому МДНФ строится эвристикой Espresso на wide_cube (wide_espresso).
+Результат - в wide_mdnf, статистика - только общее время и количество импликант \n
+Сложность - как у wide_espresso::minimize
+\param[in]		options		Параметры минимизации
+\throw			logic_error	Исключение, если способ минимизации - не e_espresso
+\throw			logic_error	Исключение, если задан кэш (его ключи строятся по cube)
+*/
+auto Quine_McCluskey_Simplifier::simplify_wide(const simplify_options& options) -> void {
+	if (options.engine != e_espresso)
+		throw std::logic_error("Functions of more than 64 variables require the espresso engine.");
+	if (options.cache)
+		throw std::logic_error("The result cache does not support more than 64 variables.");
+	const auto start = std::chrono::steady_clock::now();
+	mdnf_.clear();
+	wide_mdnf_.clear();
+	const wide_espresso engine(vars_, wide_dont_cares_);
+	for (const auto& i : engine.minimize(wide_ones_))
+		wide_mdnf_.insert(i);
+	minimal_ = false;
+	if (options.stats) {
+		simplify_stats stats;
+		stats.implicants_ms = stats.total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		stats.terms = wide_mdnf_.size();
+		*options.stats = stats;
+	}
+}
+
+/**
+Печатает статистику в поток: по строке на величину \n
+Сложность \f$O(r)\f$, где \f$r\f$ - количество раундов склейки
+\param[in]		os			Поток для печати
+*/
+auto simplify_stats::print(std::ostream& os) const -> void {
+	os << "total_ms: " << total_ms << "\n"
+		<< "implicants_ms: " << implicants_ms << "\n"
+		<< "table_ms: " << table_ms << "\n"
+		<< "core_ms: " << core_ms << "\n"
+		<< "reduce_ms: " << reduce_ms << "\n"
+		<< "cover_ms: " << cover_ms << "\n"
+		<< "rounds: " << rounds << "\n"
+		<< "cubes_per_round:";
+	for (const auto i : cubes_per_round)
+		os << " " << i;
+	os << "\n"
+		<< "comparisons: " << comparisons << "\n"
+		<< "primes: " << primes << "\n"
+		<< "essential: " << essential << "\n"
+		<< "table: " << table_rows << " x " << table_cols << "\n"
+		<< "cyclic_core: " << core_rows << " x " << core_cols << "\n"
+		<< "reduce_picks: " << reduce_picks << "\n"
+		<< "cover_picks: " << cover_picks << "\n"
+		<< "exact_nodes: " << nodes << "\n"
+		<< "terms: " << terms << "\n";
+}
+
+/**
+Доказана ли минимальность полученной ДНФ (по количеству импликант). Это так,
+если последний вызов simplify использовал точный выбор покрытия и уложился в бюджет \n
+Сложность \f$O(1)\f$
+*/
+auto Quine_McCluskey_Simplifier::is_minimal() const -> bool {
+	return minimal_;
+}
+
+/**
+Полученная МДНФ (пустая, если минимизация не производилась) \n
+Сложность \f$O(1)\f$
+*/
+auto Quine_McCluskey_Simplifier::mdnf() const -> const std::set<cube>& {
+	return mdnf_;
+}
+
+/**
+Полученная МДНФ функции больше чем от 64 переменных (пустая для остальных функций) \n
+Сложность \f$O(1)\f$
+*/
+auto Quine_McCluskey_Simplifier::wide_mdnf() const -> const std::set<wide_cube>& {
+	return wide_mdnf_;
+}
+
+/**
+Количество переменных функции - длина строк, которые печатает print_mdnf \n
+Сложность \f$O(1)\f$
+*/
+auto Quine_McCluskey_Simplifier::variables() const -> size_t {
+	return vars_;
 }
 
 /**
@@ -555,38 +978,9 @@ auto Quine_McCluskey_Simplifier::simplify() -> void {
 \param[in]		os			Поток для печати
 */
 auto Quine_McCluskey_Simplifier::print_formula(std::ostream& os) const -> void {
-	if (mdnf_.size() == 0)
+	const auto terms = mdnf_strings();
+	if (terms.size() == 0)
 		throw std::logic_error("Function not simplified!");
-	for (const auto i : mdnf_) // O(n)
+	for (const auto& i : terms) // O(n)
 		os << impl_to_formula(i) << " ";
 }
-
-/**
-Конвертирует входную строку, представляющую десятичное число, в выходную строку,
-представлляющую двоичное число\n
-Сложность \f$O(n^2)\f$, где \f$n\f$ - длина строки inp
-\param[in]		inp		Десятичная строка
-\param[out]		res		Двоичная строка
-*/
-auto Quine_McCluskey_Simplifier::string_base10_to_base2(std::string inp) const -> std::string {
-	std::string res; // O(1)
-	std::string right; // O(1)
-	do {
-		right.clear(); // O(n), n - длина right
-		int left = 0;
-		for (size_t i = 0; i < inp.length(); ++i) {
-			left = left * 10 + (inp[i] - '0');
-			const auto div = left / 2;
-			if ((i != 0) || (div != 0)) {
-				right.push_back(div + '0'); // O(1)
-				left %= 2;
-			}
-		}
-		res.push_back(left + '0'); // O(1)
-		inp = right;
-	} while (inp != std::string()); // O(n), n - длина inp
-
-	for (size_t i = 0; i < res.length() / 2; ++i) // O(n/2)
-		std::swap(res[i], res[res.length() - 1 - i]); // O(1)
-	return res;
-}
@@ -0,0 +1,69 @@
+#include "batch_simplifier.hpp"
+
+//////////////////////////////////////////////
+//                                          //
+//             batch_simplifier             //
+//                                          //
+//////////////////////////////////////////////
+
+/**
+Конструктор. Создает по рабочему объекту на поток \n
+Сложность \f$O(t)\f$, где \f$t\f$ - количество потоков
+\param[in]		threads		Количество потоков, 0 - столько, сколько ядер у процессора
+*/
+batch_simplifier::batch_simplifier(const size_t threads)
+	: workspaces_(threads != 0 ? threads : std::max<size_t>(std::thread::hardware_concurrency(), 1)) {}
+
+/**
+Минимизирует все функции и возвращает результаты в том же порядке \n
+Сложность - сумма сложностей Quine_McCluskey_Simplifier::simplify по функциям, деленная на \f$t\f$
+\param[in]		functions	Функции для минимизации
+\param[in]		options		Параметры минимизации, общие для всех функций (options.stats не заполняется,
+							options.cache используется всеми потоками)
+\param[out]		results		Результаты, results[i] - для functions[i]
+\throw			logic_error	Исключение из минимизации какой-либо функции (первое из пойманных)
+*/
+auto batch_simplifier::simplify(const std::vector<boolean_function>& functions, const simplify_options& options) -> std::vector<simplify_result> {
+	std::vector<simplify_result> results(functions.size());
+	// Одна статистика на все потоки заполнялась бы наперегонки
+	auto shared = options;
+	shared.stats = nullptr;
+	std::atomic<size_t> next(0);
+	std::exception_ptr error;
+	std::mutex error_lock;
+	auto worker = [&](const size_t t) {
+		auto& workspace = workspaces_[t];
+		try {
+			for (auto i = next.fetch_add(1); i < functions.size(); i = next.fetch_add(1)) {
+				workspace.init(functions[i].ones, functions[i].dont_cares);
+				workspace.simplify(shared);
+				auto& result = results[i];
+				result.vars = workspace.variables();
+				result.mdnf.assign(workspace.mdnf().begin(), workspace.mdnf().end());
+				result.minimal = workspace.is_minimal();
+			}
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(error_lock);
+			if (!error)
+				error = std::current_exception();
+			// Остальные потоки дорабатывают свои функции и останавливаются
+			next = functions.size();
+		}
+	};
+	const auto count = std::min(workspaces_.size(), functions.size());
+	if (count <= 1) {
+		if (count == 1)
+			worker(0);
+	}
+	else {
+		std::vector<std::thread> pool;
+		for (size_t t = 0; t < count; ++t)
+			pool.emplace_back(worker, t);
+		for (auto& t : pool)
+			t.join();
+	}
+	if (error)
+		std::rethrow_exception(error);
+	return results;
+}
@@ -0,0 +1,365 @@
+#include "bdd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+//////////////////////////////////////////////
+//                                          //
+//                   bdd                    //
+//                                          //
+//////////////////////////////////////////////
+
+namespace {
+	/**
+	"Переменная" констант - ниже всех настоящих переменных
+	*/
+	const size_t terminal = ~size_t(0);
+}
+
+/**
+Конструктор, создает константы 0 и 1 \n
+Сложность \f$O(1)\f$
+\param[in]		vars		Количество переменных (не больше 64)
+\throw			logic_error	Исключение, если переменных больше 64
+*/
+bdd::bdd(const size_t vars)
+	: vars_(vars) {
+	if (vars > 64)
+		throw std::logic_error("Too many variables.");
+	nodes_.push_back({ terminal, zero, zero });
+	nodes_.push_back({ terminal, one, one });
+}
+
+/**
+Узел (var, low, high) - существующий, если такой уже есть, иначе новый.
+Узел с равными потомками не создается \n
+Сложность \f$O(1)\f$ (в среднем)
+\param[in]		var			Переменная
+\param[in]		low			Потомок при var = 0
+\param[in]		high		Потомок при var = 1
+*/
+auto bdd::make(const size_t var, const size_t low, const size_t high) -> size_t {
+	if (low == high)
+		return low;
+	const triple key = { var, low, high };
+	const auto it = unique_.find(key);
+	if (it != unique_.end())
+		return it->second;
+	nodes_.push_back({ var, low, high });
+	unique_.emplace(key, nodes_.size() - 1);
+	return nodes_.size() - 1;
+}
+
+/**
+Кофактор функции f по переменной var, не ниже верхней переменной f \n
+Сложность \f$O(1)\f$
+*/
+auto bdd::cofactor(const size_t f, const size_t var, const bool value) const -> size_t {
+	if (nodes_[f].var != var)
+		return f;
+	return value ? nodes_[f].high : nodes_[f].low;
+}
+
+/**
+Функция, равная переменной с номером k \n
+Сложность \f$O(1)\f$
+\throw			logic_error	Исключение, если такой переменной нет
+*/
+auto bdd::variable(const size_t k) -> size_t {
+	if (k >= vars_)
+		throw std::logic_error("Too many variables.");
+	return make(k, zero, one);
+}
+
+/**
+If-then-else: f ? g : h. Разложение по верхней из переменных трех функций,
+результаты запоминаются в computed_ \n
+Сложность \f$O(|f| \cdot |g| \cdot |h|)\f$ в худшем случае
+*/
+auto bdd::ite(const size_t f, const size_t g, const size_t h) -> size_t {
+	if (f == one)
+		return g;
+	if (f == zero)
+		return h;
+	if (g == h)
+		return g;
+	if (g == one && h == zero)
+		return f;
+	const triple key = { f, g, h };
+	const auto it = computed_.find(key);
+	if (it != computed_.end())
+		return it->second;
+	const auto var = std::min({ nodes_[f].var, nodes_[g].var, nodes_[h].var });
+	const auto high = ite(cofactor(f, var, true), cofactor(g, var, true), cofactor(h, var, true));
+	const auto low = ite(cofactor(f, var, false), cofactor(g, var, false), cofactor(h, var, false));
+	const auto res = make(var, low, high);
+	computed_.emplace(key, res);
+	return res;
+}
+
+auto bdd::negate(const size_t f) -> size_t {
+	return ite(f, zero, one);
+}
+
+auto bdd::conj(const size_t f, const size_t g) -> size_t {
+	return ite(f, g, zero);
+}
+
+auto bdd::disj(const size_t f, const size_t g) -> size_t {
+	return ite(f, one, g);
+}
+
+/**
+Объединение кубов, в которых переменные до var уже разобраны. Кубы с заданной var делятся
+по ее значению, а кубы с '-' в var не копируются в обе половины (тогда их число росло бы
+экспоненциально от количества '-'): их объединение строится отдельно и добавляется
+дизъюнкцией. Каждый куб попадает ровно в одну ветвь \n
+Сложность \f$O(k \cdot n)\f$ на разбиение и не больше \f$k \cdot n\f$ дизъюнкций,
+каждая не дороже \f$O(|f| \cdot |g|)\f$ (для наборов без '-' дизъюнкций нет)
+\param[in]		items		Кубы
+\param[in]		var			Текущая переменная
+*/
+auto bdd::build(const std::vector<cube>& items, const size_t var) -> size_t {
+	if (items.empty())
+		return zero;
+	if (var == vars_)
+		return one;
+	const auto bit = std::uint64_t(1) << var;
+	std::vector<cube> low, high, free;
+	for (const auto& c : items) {
+		if (c.mask(0) & bit)
+			free.push_back(c);
+		else if (c.value(0) & bit)
+			high.push_back(c);
+		else
+			low.push_back(c);
+	}
+	const auto l = build(low, var + 1);
+	low = std::vector<cube>();
+	const auto h = build(high, var + 1);
+	high = std::vector<cube>();
+	const auto res = make(var, l, h);
+	return free.empty() ? res : disj(res, build(free, var + 1));
+}
+
+/**
+Функция, равная единице ровно на наборах, покрытых кубами (наборы - кубы без '-').
+Строится сразу по кубам, без дизъюнкции по одному (см. build). Промежуточные
+дизъюнкции больше не нужны, поэтому кэш ITE после построения очищается \n
+Сложность \f$O(k \cdot n)\f$ для \f$k\f$ наборов, для кубов с '-' - плюс дизъюнкции (см. build)
+\param[in]		items		Кубы
+\param[out]		res			Диаграмма
+*/
+auto bdd::from_cubes(const std::vector<cube>& items) -> size_t {
+	const auto res = build(items, 0);
+	computed_.clear();
+	return res;
+}
+
+/**
+Сборка мусора: оставляет только узлы, достижимые из roots, и перенумеровывает их
+(номера roots обновляются), кэш ITE очищается. Потомки всегда создаются раньше родителя,
+поэтому узлы переносятся одним проходом по возрастанию номеров. Старые номера функций,
+не вошедших в roots, после этого недействительны \n
+Сложность \f$O(N)\f$, где \f$N\f$ - количество узлов до сборки
+\param[in]		roots		Функции, которые нужно сохранить
+*/
+auto bdd::collect(std::vector<size_t>& roots) -> void {
+	std::vector<bool> alive(nodes_.size(), false);
+	alive[zero] = alive[one] = true;
+	std::vector<size_t> todo(roots.begin(), roots.end());
+	while (!todo.empty()) {
+		const auto x = todo.back();
+		todo.pop_back();
+		if (alive[x])
+			continue;
+		alive[x] = true;
+		todo.push_back(nodes_[x].low);
+		todo.push_back(nodes_[x].high);
+	}
+	std::vector<size_t> renum(nodes_.size(), zero);
+	renum[one] = one;
+	size_t size = 2;
+	unique_.clear();
+	for (size_t x = 2; x < nodes_.size(); ++x) {
+		if (!alive[x])
+			continue;
+		const node moved = { nodes_[x].var, renum[nodes_[x].low], renum[nodes_[x].high] };
+		nodes_[size] = moved;
+		unique_.emplace(triple{ moved.var, moved.low, moved.high }, size);
+		renum[x] = size++;
+	}
+	nodes_.resize(size);
+	computed_.clear();
+	for (auto& f : roots)
+		f = renum[f];
+}
+
+/**
+Обход всех путей в 1: на каждом пути пропущенные переменные принимают все значения \n
+Сложность \f$O(|f| + k)\f$, где \f$k\f$ - количество единиц
+\param[in]		f			Текущий узел
+\param[in]		value		Значения переменных, заданных на пути
+\param[in]		fixed		Переменные, заданные на пути
+\param[in]		res			Куда дописывать наборы
+*/
+auto bdd::paths(const size_t f, std::uint64_t value, std::uint64_t fixed, std::vector<std::uint64_t>& res) const -> void {
+	if (f == zero)
+		return;
+	if (f == one) {
+		const auto all = vars_ >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << vars_) - 1;
+		const auto free = all & ~fixed;
+		// Все подмножества free
+		for (auto s = free;; s = (s - 1) & free) {
+			res.push_back(value | s);
+			if (s == 0)
+				break;
+		}
+		return;
+	}
+	const auto bit = std::uint64_t(1) << nodes_[f].var;
+	paths(nodes_[f].low, value, fixed | bit, res);
+	paths(nodes_[f].high, value | bit, fixed | bit, res);
+}
+
+/**
+Значение функции на наборе \n
+Сложность \f$O(n)\f$
+\param[in]		f			Функция
+\param[in]		set			Номер набора
+*/
+auto bdd::value(size_t f, const std::uint64_t set) const -> bool {
+	while (f != zero && f != one)
+		f = (set >> nodes_[f].var) & 1 ? nodes_[f].high : nodes_[f].low;
+	return f == one;
+}
+
+/**
+Кофактор функции по кубу: заданные в кубе переменные заменяются их значениями,
+остальные остаются \n
+Сложность \f$O(|f|)\f$
+\param[in]		f			Функция
+\param[in]		c			Куб
+\param[out]		res			Функция от переменных, которые в кубе '-'
+*/
+auto bdd::cofactor(const size_t f, const cube& c) -> size_t {
+	std::unordered_map<size_t, size_t> done;
+	return cofactor(f, c, done);
+}
+
+/**
+Кофактор по кубу для узла f, уже посчитанные узлы - в done \n
+Сложность \f$O(|f|)\f$, глубина рекурсии не больше количества переменных
+*/
+auto bdd::cofactor(const size_t f, const cube& c, std::unordered_map<size_t, size_t>& done) -> size_t {
+	if (f == zero || f == one)
+		return f;
+	const auto it = done.find(f);
+	if (it != done.end())
+		return it->second;
+	const auto x = nodes_[f];
+	const auto bit = std::uint64_t(1) << x.var;
+	size_t res;
+	if (c.mask(0) & bit)
+		res = make(x.var, cofactor(x.low, c, done), cofactor(x.high, c, done));
+	else
+		res = cofactor((c.value(0) & bit) ? x.high : x.low, c, done);
+	done.emplace(f, res);
+	return res;
+}
+
+/**
+Количество единиц функции (без их перечисления). Число с плавающей точкой,
+так как при 64 переменных единиц может быть \f$2^{64}\f$ \n
+Сложность \f$O(|f|)\f$ в среднем
+\param[in]		f			Функция
+\param[out]		res			Количество наборов, на которых f равна единице
+*/
+auto bdd::count(const size_t f) const -> double {
+	// Доля единиц среди наборов переменных от var(x) и ниже
+	std::unordered_map<size_t, double> done;
+	done[zero] = 0;
+	done[one] = 1;
+	std::vector<size_t> todo(1, f);
+	while (!todo.empty()) {
+		const auto x = todo.back();
+		if (done.count(x)) {
+			todo.pop_back();
+			continue;
+		}
+		const auto low = done.find(nodes_[x].low), high = done.find(nodes_[x].high);
+		if (low != done.end() && high != done.end()) {
+			done[x] = (low->second + high->second) / 2;
+			todo.pop_back();
+			continue;
+		}
+		if (low == done.end())
+			todo.push_back(nodes_[x].low);
+		if (high == done.end())
+			todo.push_back(nodes_[x].high);
+	}
+	return std::ldexp(done[f], static_cast<int>(vars_));
+}
+
+/**
+Единицы функции (номера наборов) в порядке возрастания. Таблица истинности не строится:
+наборы выписываются по путям диаграммы \n
+Сложность \f$O(|f| + k \cdot \log(k))\f$, где \f$k\f$ - количество единиц
+\param[in]		f			Функция
+\param[out]		res			Номера наборов
+\throw			logic_error	Исключение, если переменных больше 63
+*/
+auto bdd::minterms(const size_t f) const -> std::vector<std::uint64_t> {
+	if (vars_ > 63)
+		throw std::logic_error("Too many variables.");
+	std::vector<std::uint64_t> res;
+	paths(f, 0, 0, res);
+	std::sort(res.begin(), res.end());
+	return res;
+}
+
+/**
+Неизбыточное покрытие из простых импликант для функций l <= f <= u
+(алгоритм Минато-Морреале, ISOP). Кубы с отрицанием верхней переменной,
+без отрицания и без нее строятся отдельно \n
+Сложность зависит от размера диаграмм, а не от количества наборов
+\param[in]		l			Наборы, которые нужно покрыть
+\param[in]		u			Наборы, которые можно покрыть
+\param[in]		value		Значения уже заданных переменных куба
+\param[in]		mask		Еще не заданные переменные куба ('-')
+\param[in]		res			Куда дописывать кубы
+\param[out]		cover		Диаграмма полученного покрытия
+*/
+auto bdd::isop(const size_t l, const size_t u, const std::uint64_t value, const std::uint64_t mask, std::vector<cube>& res) -> size_t {
+	if (l == zero)
+		return zero;
+	if (u == one) {
+		res.push_back(cube(value, mask));
+		return one;
+	}
+	const auto var = std::min(nodes_[l].var, nodes_[u].var);
+	const auto bit = std::uint64_t(1) << var;
+	const auto l0 = cofactor(l, var, false), l1 = cofactor(l, var, true);
+	const auto u0 = cofactor(u, var, false), u1 = cofactor(u, var, true);
+	const auto f0 = isop(conj(l0, negate(u1)), u0, value, mask & ~bit, res);
+	const auto f1 = isop(conj(l1, negate(u0)), u1, value | bit, mask & ~bit, res);
+	const auto rest = disj(conj(l0, negate(f0)), conj(l1, negate(f1)));
+	const auto fd = isop(rest, conj(u0, u1), value, mask, res);
+	return make(var, disj(f0, fd), disj(f1, fd));
+}
+
+/**
+Покрытие функции простыми импликантами, в котором нет лишних импликант (но их количество
+не обязательно минимально). Неопределенные наборы можно покрывать, но не обязательно \n
+Сложность зависит от размера диаграмм, а не от количества наборов
+\param[in]		ones		Функция
+\param[in]		dont_cares	Неопределенные наборы
+\param[out]		res			Кубы покрытия по возрастанию
+*/
+auto bdd::prime_cover(const size_t ones, const size_t dont_cares) -> std::vector<cube> {
+	const auto all = vars_ >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << vars_) - 1;
+	std::vector<cube> res;
+	isop(ones, disj(ones, dont_cares), 0, all, res);
+	std::sort(res.begin(), res.end());
+	return res;
+}
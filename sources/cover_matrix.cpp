@@ -0,0 +1,83 @@
+#include "cover_matrix.hpp"
+
+//////////////////////////////////////////////
+//                                          //
+//               cover_matrix               //
+//                                          //
+//////////////////////////////////////////////
+
+/**
+Конструктор. Создает таблицу rows x cols из одних нулей \n
+Сложность \f$O(k \cdot m / 64)\f$, где \f$k\f$ - количество строк, \f$m\f$ - количество столбцов
+\param[in]		rows		Количество строк (наборов)
+\param[in]		cols		Количество столбцов (импликант)
+*/
+cover_matrix::cover_matrix(const size_t rows, const size_t cols)
+	: rows_(rows),
+	cols_(cols),
+	row_words_((cols + 63) / 64),
+	col_words_((rows + 63) / 64),
+	by_rows_(rows * ((cols + 63) / 64), 0),
+	by_cols_(cols * ((rows + 63) / 64), 0) {}
+
+/**
+Ставит 1 в ячейку (r, c) \n
+Сложность \f$O(1)\f$
+*/
+auto cover_matrix::set(const size_t r, const size_t c) -> void {
+	by_rows_[r * row_words_ + c / 64] |= std::uint64_t(1) << (c % 64);
+	by_cols_[c * col_words_ + r / 64] |= std::uint64_t(1) << (r % 64);
+}
+
+/**
+Значение ячейки (r, c) \n
+Сложность \f$O(1)\f$
+*/
+auto cover_matrix::get(const size_t r, const size_t c) const -> bool {
+	return ((by_rows_[r * row_words_ + c / 64] >> (c % 64)) & 1) != 0;
+}
+
+/**
+Количество единиц в строке r - сколько импликант покрывает набор \n
+Сложность \f$O(m / 64)\f$, где \f$m\f$ - количество столбцов
+*/
+auto cover_matrix::row_count(const size_t r) const -> size_t {
+	size_t res = 0;
+	const auto p = row(r);
+	for (size_t w = 0; w < row_words_; ++w)
+		res += bits::popcount(p[w]);
+	return res;
+}
+
+/**
+Количество единиц в столбце c - сколько наборов покрывает импликант \n
+Сложность \f$O(k / 64)\f$, где \f$k\f$ - количество строк
+*/
+auto cover_matrix::col_count(const size_t c) const -> size_t {
+	size_t res = 0;
+	const auto p = col(c);
+	for (size_t w = 0; w < col_words_; ++w)
+		res += bits::popcount(p[w]);
+	return res;
+}
+
+/**
+Номер первого столбца, в котором в строке r стоит 1 \n
+Сложность \f$O(m / 64)\f$, где \f$m\f$ - количество столбцов
+\param[out]		j			Номер столбца или cols(), если строка пустая
+*/
+auto cover_matrix::first_in_row(const size_t r) const -> size_t {
+	const auto p = row(r);
+	for (size_t w = 0; w < row_words_; ++w)
+		if (p[w])
+			return w * 64 + bits::lowest(p[w]);
+	return cols_;
+}
+
+/**
+Освобождает память таблицы \n
+Сложность \f$O(1)\f$
+*/
+auto cover_matrix::clear() -> void {
+	*this = cover_matrix();
+}
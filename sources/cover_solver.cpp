@@ -0,0 +1,468 @@
+#include "cover_solver.hpp"
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+
+//////////////////////////////////////////////
+//                                          //
+//               cover_solver               //
+//                                          //
+//////////////////////////////////////////////
+
+namespace {
+	auto test(const std::vector<std::uint64_t>& x, const size_t i) -> bool {
+		return ((x[i / 64] >> (i % 64)) & 1) != 0;
+	}
+
+	auto reset(std::vector<std::uint64_t>& x, const size_t i) -> void {
+		x[i / 64] &= ~(std::uint64_t(1) << (i % 64));
+	}
+
+	auto count_and(const std::uint64_t* x, const std::vector<std::uint64_t>& y) -> size_t {
+		size_t res = 0;
+		for (size_t w = 0; w < y.size(); ++w)
+			res += bits::popcount(x[w] & y[w]);
+		return res;
+	}
+
+	auto first_and(const std::uint64_t* x, const std::vector<std::uint64_t>& y) -> size_t {
+		for (size_t w = 0; w < y.size(); ++w)
+			if (x[w] & y[w])
+				return w * 64 + bits::lowest(x[w] & y[w]);
+		return y.size() * 64;
+	}
+
+	auto any(const std::vector<std::uint64_t>& x) -> bool {
+		for (const auto w : x)
+			if (w)
+				return true;
+		return false;
+	}
+
+	/**
+	Все биты от 0 до n - 1 установлены
+	*/
+	auto full(const size_t n) -> std::vector<std::uint64_t> {
+		std::vector<std::uint64_t> res((n + 63) / 64, ~std::uint64_t(0));
+		if (n % 64)
+			res.back() = (std::uint64_t(1) << (n % 64)) - 1;
+		return res;
+	}
+
+	/**
+	Множества в виде списков: элементы множества i по возрастанию лежат
+	в items с from[i] по from[i + 1] - 1
+	*/
+	struct set_lists {
+		std::vector<size_t> from;
+		std::vector<size_t> items;
+
+		auto size(const size_t i) const -> size_t { return from[i + 1] - from[i]; }
+	};
+
+	/**
+	Добавляет в lists множество - строку (или столбец) src, суженную на живые столбцы (строки) alive
+	*/
+	auto add_masked(set_lists& lists, const std::uint64_t* src, const std::vector<std::uint64_t>& alive) -> void {
+		if (lists.from.empty())
+			lists.from.push_back(0);
+		for (size_t w = 0; w < alive.size(); ++w)
+			for (auto x = src[w] & alive[w]; x; x &= x - 1)
+				lists.items.push_back(w * 64 + bits::lowest(x));
+		lists.from.push_back(lists.items.size());
+	}
+
+	/**
+	Сужает живые (из alive_sets) множества all на живые элементы alive_items,
+	номера оставшихся множеств записывает в ids
+	*/
+	auto filtered(const set_lists& all, const std::vector<std::uint64_t>& alive_sets,
+		const std::vector<std::uint64_t>& alive_items, std::vector<size_t>& ids) -> set_lists {
+		set_lists res;
+		res.from.push_back(0);
+		ids.clear();
+		for (size_t a = 0; a + 1 < all.from.size(); ++a) {
+			if (!test(alive_sets, a))
+				continue;
+			ids.push_back(a);
+			for (auto i = all.from[a]; i < all.from[a + 1]; ++i)
+				if (test(alive_items, all.items[i]))
+					res.items.push_back(all.items[i]);
+			res.from.push_back(res.items.size());
+		}
+		return res;
+	}
+
+	/**
+	Удаляет доминируемые элементы. Если remove_supersets, то элемент a удаляется, когда есть
+	живой b, множество которого (уже суженное) - подмножество множества a (так сокращаются строки);
+	иначе a удаляется, когда его множество - подмножество множества b (так сокращаются столбцы).
+	При равенстве множеств остается элемент с меньшим номером. \n
+	Пары сравниваются не все: подмножество a начинается с какого-то элемента a, а надмножество a
+	содержит элемент a, входящий в меньше всего множеств. Такие кандидаты берутся из индексов
+	по элементам, а проверка кандидата b идет по отмеченным элементам a за \f$O(|b|)\f$ \n
+	Сложность \f$O(s + c)\f$, где \f$s\f$ - количество элементов во всех множествах,
+	\f$c\f$ - суммарный размер проверенных кандидатов
+	\param[in]		sets				Суженные множества живых элементов, в порядке ids
+	\param[in]		elements			Количество возможных элементов множеств
+	\param[in]		alive				Живые элементы (битовое множество), здесь сбрасываются удаленные
+	\param[in]		ids					Номера элементов
+	\param[in]		remove_supersets	Удалять надмножества (строки) или подмножества (столбцы)
+	\param[out]		true/false			Удален ли хотя бы один элемент
+	*/
+	auto remove_dominated(const set_lists& sets, const size_t elements,
+		std::vector<std::uint64_t>& alive, const std::vector<size_t>& ids, const bool remove_supersets) -> bool {
+		// Множества, начинающиеся с элемента, и множества, содержащие элемент - в том же виде
+		set_lists starting, containing;
+		starting.from.assign(elements + 1, 0);
+		containing.from.assign(elements + 1, 0);
+		for (size_t a = 0; a < ids.size(); ++a) {
+			if (sets.size(a) != 0)
+				++starting.from[sets.items[sets.from[a]] + 1];
+			for (auto i = sets.from[a]; i < sets.from[a + 1]; ++i)
+				++containing.from[sets.items[i] + 1];
+		}
+		for (size_t e = 0; e < elements; ++e) {
+			starting.from[e + 1] += starting.from[e];
+			containing.from[e + 1] += containing.from[e];
+		}
+		starting.items.resize(starting.from.back());
+		containing.items.resize(containing.from.back());
+		{
+			auto s_pos = starting.from, c_pos = containing.from;
+			for (size_t a = 0; a < ids.size(); ++a) {
+				if (sets.size(a) != 0)
+					starting.items[s_pos[sets.items[sets.from[a]]]++] = a;
+				for (auto i = sets.from[a]; i < sets.from[a + 1]; ++i)
+					containing.items[c_pos[sets.items[i]]++] = a;
+			}
+		}
+		// Отмечены элементы текущего a
+		std::vector<char> marked(elements, 0);
+		// Доминирует ли живой b над a
+		auto dominates = [&](const size_t a, const size_t b) {
+			if (a == b || !test(alive, ids[b]))
+				return false;
+			const auto size_a = sets.size(a), size_b = sets.size(b);
+			if (remove_supersets ? size_b > size_a : size_a > size_b)
+				return false;
+			size_t common = 0;
+			for (auto i = sets.from[b]; i < sets.from[b + 1]; ++i)
+				common += marked[sets.items[i]];
+			if (common != (remove_supersets ? size_b : size_a))
+				return false;
+			return size_a != size_b || ids[b] < ids[a];
+		};
+		auto changed = false;
+		for (size_t a = 0; a < ids.size(); ++a) {
+			if (!test(alive, ids[a]) || sets.size(a) == 0)
+				continue;
+			for (auto i = sets.from[a]; i < sets.from[a + 1]; ++i)
+				marked[sets.items[i]] = 1;
+			auto found = false;
+			if (remove_supersets) {
+				for (auto i = sets.from[a]; i < sets.from[a + 1] && !found; ++i) {
+					const auto e = sets.items[i];
+					for (auto j = starting.from[e]; j < starting.from[e + 1] && !found; ++j)
+						found = dominates(a, starting.items[j]);
+				}
+			}
+			else {
+				// Надмножество a содержит каждый элемент a, в том числе самый редкий
+				auto rarest = sets.items[sets.from[a]];
+				for (auto i = sets.from[a]; i < sets.from[a + 1]; ++i)
+					if (containing.size(sets.items[i]) < containing.size(rarest))
+						rarest = sets.items[i];
+				for (auto j = containing.from[rarest]; j < containing.from[rarest + 1] && !found; ++j)
+					found = dominates(a, containing.items[j]);
+			}
+			for (auto i = sets.from[a]; i < sets.from[a + 1]; ++i)
+				marked[sets.items[i]] = 0;
+			if (found) {
+				reset(alive, ids[a]);
+				changed = true;
+			}
+		}
+		return changed;
+	}
+}
+
+/**
+Конструктор. Все строки нужно покрыть, все столбцы доступны \n
+Сложность \f$O((k + m) / 64)\f$
+\param[in]		table		Таблица покрытия
+*/
+cover_solver::cover_solver(const cover_matrix& table)
+	: table_(table),
+	rows_(full(table.rows())),
+	cols_(full(table.cols())) {}
+
+/**
+Сокращает таблицу до неподвижной точки (см. reduce с параметрами) и запоминает то, что осталось.
+После этого greedy и exact выбирают покрытие только для оставшихся строк из оставшихся столбцов \n
+Сложность \f$O(k \cdot m / 64)\f$ и \f$O(s + c)\f$ на проход (см. reduce с параметрами)
+\param[out]	chosen		Существенные столбцы, выбранные при сокращении
+\throw	logic_error	Исключение, если какую-то строку нельзя покрыть
+*/
+auto cover_solver::reduce() -> std::vector<size_t> {
+	std::vector<size_t> chosen;
+	if (!reduce(rows_, cols_, chosen))
+		throw std::logic_error("What?");
+	return chosen;
+}
+
+/**
+Жадно выбирает импликанты (столбцы table) до тех пор, пока не будут покрыты все наборы (строки):
+каждый раз берется столбец, покрывающий больше всего еще не покрытых строк, при равенстве -
+с меньшим номером. Количества покрытий хранятся в очереди с приоритетами и обновляются
+только для тех столбцов, которые пересекаются с только что покрытыми строками
+(устаревшие записи очереди просто пропускаются), так что таблица не перестраивается \n
+Сложность \f$O(s \cdot log(s))\f$, где \f$s\f$ - количество единиц в таблице
+\param[out]	cover		Номера выбранных столбцов в порядке выбора
+\throw	logic_error	Исключение, если какую-то строку нельзя покрыть
+*/
+auto cover_solver::greedy() const -> std::vector<size_t> {
+	std::vector<size_t> cover;
+	std::vector<size_t> counts(table_.cols(), 0);
+	std::vector<char> covered(table_.rows(), 0);
+	for (size_t i = 0; i < table_.rows(); ++i)
+		covered[i] = !test(rows_, i);
+	// Наверху - наибольшее покрытие, при равенстве - меньший номер
+	std::priority_queue<std::pair<size_t, size_t>, std::vector<std::pair<size_t, size_t>>,
+		bool(*)(const std::pair<size_t, size_t>&, const std::pair<size_t, size_t>&)> queue(
+			[](const std::pair<size_t, size_t>& x, const std::pair<size_t, size_t>& y) {
+		return std::get<0>(x) != std::get<0>(y) ? std::get<0>(x) < std::get<0>(y) : std::get<1>(x) > std::get<1>(y);
+	});
+	for (size_t j = 0; j < table_.cols(); ++j) { // O(m)
+		if (!test(cols_, j))
+			continue;
+		counts[j] = count_and(table_.col(j), rows_); // O(k / 64)
+		if (counts[j] != 0)
+			queue.push(std::make_pair(counts[j], j));
+	}
+	auto left = count(rows_);
+	while (left != 0) {
+		if (queue.empty())
+			throw std::logic_error("What?");
+		const auto top = queue.top();
+		queue.pop();
+		const auto j = std::get<1>(top);
+		if (counts[j] == 0)
+			continue;
+		if (std::get<0>(top) != counts[j]) {
+			queue.push(std::make_pair(counts[j], j));
+			continue;
+		}
+		cover.push_back(j);
+		table_.for_each_in_col(j, [&](size_t i) {
+			if (covered[i])
+				return;
+			covered[i] = 1;
+			--left;
+			table_.for_each_in_row(i, [&counts](size_t k) { --counts[k]; });
+		});
+	}
+	return cover;
+}
+
+/**
+Точный выбор покрытия методом ветвей и границ. Начинает с жадного покрытия как верхней границы.
+Если перебор не уложился в бюджет, возвращает лучшее найденное покрытие (см. optimal()) \n
+Сложность в худшем случае экспоненциальная, но ограничена бюджетом
+\param[in]		node_limit	Максимальное количество узлов перебора
+\param[in]		time_limit	Максимальное время перебора
+\param[out]		cover		Номера выбранных столбцов
+\throw	logic_error	Исключение, если какую-то строку нельзя покрыть
+*/
+auto cover_solver::exact(const size_t node_limit, const std::chrono::milliseconds time_limit) -> std::vector<size_t> {
+	best_ = greedy();
+	nodes_ = 0;
+	node_limit_ = node_limit;
+	deadline_ = std::chrono::steady_clock::now() + time_limit;
+	aborted_ = false;
+	search(rows_, cols_, std::vector<size_t>(), true);
+	return best_;
+}
+
+/**
+Количество элементов битового множества \n
+Сложность \f$O(n / 64)\f$
+*/
+auto cover_solver::count(const std::vector<std::uint64_t>& x) const -> size_t {
+	size_t res = 0;
+	for (const auto w : x)
+		res += bits::popcount(w);
+	return res;
+}
+
+/**
+Нижняя граница количества столбцов, которые еще нужно выбрать: жадно набирает строки,
+попарно не имеющие общих столбцов - каждой из них нужен свой столбец \n
+Сложность \f$O(k \cdot log(k) + k \cdot m / 64)\f$
+\param[in]		rows		Непокрытые строки
+\param[in]		cols		Доступные столбцы
+\param[out]		bound		Количество независимых строк
+*/
+auto cover_solver::lower_bound(const std::vector<std::uint64_t>& rows, const std::vector<std::uint64_t>& cols) const -> size_t {
+	std::vector<std::pair<size_t, size_t>> order;
+	for (size_t r = 0; r < table_.rows(); ++r)
+		if (test(rows, r))
+			order.push_back(std::make_pair(count_and(table_.row(r), cols), r));
+	std::sort(order.begin(), order.end());
+	std::vector<std::uint64_t> used(cols.size(), 0);
+	size_t bound = 0;
+	for (const auto& i : order) {
+		const auto row = table_.row(std::get<1>(i));
+		auto independent = true;
+		for (size_t w = 0; w < cols.size() && independent; ++w)
+			independent = (row[w] & cols[w] & used[w]) == 0;
+		if (independent) {
+			++bound;
+			for (size_t w = 0; w < cols.size(); ++w)
+				used[w] |= row[w] & cols[w];
+		}
+	}
+	return bound;
+}
+
+/**
+Выбирает существенные столбцы (единственные в какой-то строке) \n
+Сложность \f$O(k \cdot m / 64)\f$
+\param[in]		rows		Непокрытые строки
+\param[in]		cols		Доступные столбцы
+\param[in]		chosen		Выбранные столбцы, сюда дописываются существенные
+\param[out]		true/false	false, если какую-то строку уже нельзя покрыть
+*/
+auto cover_solver::essentials(std::vector<std::uint64_t>& rows, std::vector<std::uint64_t>& cols, std::vector<size_t>& chosen) const -> bool {
+	const auto cw = table_.col_words();
+	// Выбор столбца убирает только покрытые им строки, у остальных строк столбцы не меняются,
+	// поэтому новых существенных столбцов после него не появляется и хватает одного прохода
+	for (size_t r = 0; r < table_.rows(); ++r) {
+		if (!test(rows, r))
+			continue;
+		const auto count = count_and(table_.row(r), cols);
+		if (count == 0)
+			return false;
+		if (count == 1) {
+			const auto c = first_and(table_.row(r), cols);
+			chosen.push_back(c);
+			const auto col = table_.col(c);
+			for (size_t w = 0; w < cw; ++w)
+				rows[w] &= ~col[w];
+			reset(cols, c);
+		}
+	}
+	return true;
+}
+
+/**
+Сокращает таблицу до неподвижной точки: выбирает существенные столбцы (см. essentials),
+удаляет доминирующие строки (их покроет столбец, покрывающий доминируемую) и доминируемые
+столбцы (их заменяет столбец, покрывающий больше). После сокращения остается циклическое ядро \n
+Сложность \f$O(k \cdot m / 64)\f$ на построение списков и \f$O(s + c)\f$ на проход, где \f$s\f$ -
+количество единиц в таблице, \f$c\f$ - суммарный размер кандидатов в доминирование (см. remove_dominated)
+\param[in]		rows		Непокрытые строки
+\param[in]		cols		Доступные столбцы
+\param[in]		chosen		Выбранные столбцы, сюда дописываются существенные
+\param[out]		true/false	false, если какую-то строку уже нельзя покрыть
+*/
+auto cover_solver::reduce(std::vector<std::uint64_t>& rows, std::vector<std::uint64_t>& cols, std::vector<size_t>& chosen) const -> bool {
+	// Таблица в виде списков (строка - ее столбцы, столбец - его строки) строится один раз,
+	// дальше проходы идут только по спискам. Строки и столбцы только убывают, поэтому
+	// списки достаточно сужать на живые
+	set_lists row_sets, col_sets;
+	for (size_t r = 0; r < table_.rows(); ++r)
+		add_masked(row_sets, table_.row(r), cols);
+	for (size_t c = 0; c < table_.cols(); ++c)
+		add_masked(col_sets, table_.col(c), rows);
+	std::vector<size_t> ids;
+	auto changed = true;
+	while (changed) {
+		// Существенные столбцы (как в essentials)
+		auto sets = filtered(row_sets, rows, cols, ids);
+		for (size_t a = 0; a < ids.size(); ++a) {
+			if (!test(rows, ids[a]))
+				continue;
+			if (sets.size(a) == 0)
+				return false;
+			if (sets.size(a) == 1) {
+				const auto c = sets.items[sets.from[a]];
+				chosen.push_back(c);
+				for (auto i = col_sets.from[c]; i < col_sets.from[c + 1]; ++i)
+					reset(rows, col_sets.items[i]);
+				reset(cols, c);
+			}
+		}
+		// Доминирующие строки
+		sets = filtered(row_sets, rows, cols, ids);
+		changed = remove_dominated(sets, table_.cols(), rows, ids, true);
+		// Доминируемые столбцы (столбцы без строк просто удаляются)
+		sets = filtered(col_sets, cols, rows, ids);
+		for (size_t a = 0; a < ids.size(); ++a)
+			if (sets.size(a) == 0)
+				reset(cols, ids[a]);
+		if (remove_dominated(sets, table_.rows(), cols, ids, false))
+			changed = true;
+	}
+	return true;
+}
+
+/**
+Узел перебора: сокращение, проверка границ, ветвление по строке с наименьшим количеством
+столбцов. Полное сокращение (с доминированием) делается только в корне, в остальных
+узлах - только выбор существенных столбцов: ветвь меняет таблицу мало, а проверка
+доминирования стоит дорого. Ветви перебирают столбцы этой строки, начиная с покрывающих
+больше строк; уже рассмотренные столбцы исключаются из следующих ветвей \n
+\param[in]		rows		Непокрытые строки
+\param[in]		cols		Доступные столбцы
+\param[in]		chosen		Выбранные столбцы
+\param[in]		root		Корень ли это перебора
+*/
+auto cover_solver::search(std::vector<std::uint64_t> rows, std::vector<std::uint64_t> cols, std::vector<size_t> chosen, const bool root) -> void {
+	if (++nodes_ > node_limit_ || std::chrono::steady_clock::now() > deadline_) {
+		aborted_ = true;
+		return;
+	}
+	if (!(root ? reduce(rows, cols, chosen) : essentials(rows, cols, chosen)) || chosen.size() >= best_.size())
+		return;
+	if (!any(rows)) {
+		best_ = chosen;
+		return;
+	}
+	if (chosen.size() + lower_bound(rows, cols) >= best_.size())
+		return;
+
+	auto branch = table_.rows();
+	auto branch_count = table_.cols() + 1;
+	for (size_t r = 0; r < table_.rows(); ++r)
+		if (test(rows, r)) {
+			const auto count = count_and(table_.row(r), cols);
+			if (count < branch_count) {
+				branch = r;
+				branch_count = count;
+			}
+		}
+	std::vector<std::pair<size_t, size_t>> order;
+	for (size_t c = 0; c < table_.cols(); ++c)
+		if (test(cols, c) && table_.get(branch, c))
+			order.push_back(std::make_pair(count_and(table_.col(c), rows), c));
+	std::sort(order.begin(), order.end(), [](const std::pair<size_t, size_t>& x, const std::pair<size_t, size_t>& y) {
+		return std::get<0>(x) != std::get<0>(y) ? std::get<0>(x) > std::get<0>(y) : std::get<1>(x) < std::get<1>(y);
+	});
+	for (const auto& i : order) {
+		const auto c = std::get<1>(i);
+		auto next_rows = rows;
+		const auto col = table_.col(c);
+		for (size_t w = 0; w < next_rows.size(); ++w)
+			next_rows[w] &= ~col[w];
+		auto next_cols = cols;
+		reset(next_cols, c);
+		chosen.push_back(c);
+		search(next_rows, next_cols, chosen, false);
+		chosen.pop_back();
+		reset(cols, c);
+		if (aborted_)
+			return;
+	}
+}
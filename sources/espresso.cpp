@@ -0,0 +1,385 @@
+#include "espresso.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+//////////////////////////////////////////////
+//                                          //
+//                 espresso                 //
+//                                          //
+//////////////////////////////////////////////
+
+namespace {
+	template <std::size_t W>
+	using var_set = std::array<std::uint64_t, W>;
+
+	/**
+	Количество переменных в множестве
+	*/
+	template <std::size_t W>
+	auto count(const var_set<W>& s) -> size_t {
+		size_t res = 0;
+		for (std::size_t w = 0; w < W; ++w)
+			res += bits::popcount(s[w]);
+		return res;
+	}
+
+	template <std::size_t W>
+	auto empty(const var_set<W>& s) -> bool {
+		std::uint64_t res = 0;
+		for (std::size_t w = 0; w < W; ++w)
+			res |= s[w];
+		return res == 0;
+	}
+
+	/**
+	Вызывает f для номера каждой переменной множества, по возрастанию
+	*/
+	template <std::size_t W, typename F>
+	auto for_each_var(const var_set<W>& s, F f) -> void {
+		for (std::size_t w = 0; w < W; ++w)
+			for (auto x = s[w]; x != 0; x &= x - 1)
+				f(64 * w + bits::lowest(x));
+	}
+
+	/**
+	Установлен ли бит переменной j в слове с номером j / 64
+	*/
+	auto has(const std::uint64_t word, const size_t j) -> bool {
+		return ((word >> (j % 64)) & 1) != 0;
+	}
+
+	/**
+	Переменные из free, заданные в кубе (не '-')
+	*/
+	template <std::size_t W>
+	auto fixed(const basic_cube<W>& c, const var_set<W>& free) -> var_set<W> {
+		var_set<W> res;
+		for (std::size_t w = 0; w < W; ++w)
+			res[w] = ~c.mask(w) & free[w];
+		return res;
+	}
+
+	/**
+	Позиции, в которых оба куба заданы и различаются (если они есть, кубы не пересекаются)
+	*/
+	template <std::size_t W>
+	auto conflicts(const basic_cube<W>& a, const basic_cube<W>& b) -> var_set<W> {
+		var_set<W> res;
+		for (std::size_t w = 0; w < W; ++w)
+			res[w] = (a.value(w) ^ b.value(w)) & ~a.mask(w) & ~b.mask(w);
+		return res;
+	}
+
+	/**
+	Куб c, в котором еще и переменные extra заменены на '-'
+	*/
+	template <std::size_t W>
+	auto raise(const basic_cube<W>& c, const var_set<W>& extra) -> basic_cube<W> {
+		std::uint64_t value[W], mask[W];
+		for (std::size_t w = 0; w < W; ++w) {
+			value[w] = c.value(w);
+			mask[w] = c.mask(w) | extra[w];
+		}
+		return basic_cube<W>::from_words(value, mask);
+	}
+
+	/**
+	Куб c с '-' в переменной j
+	*/
+	template <std::size_t W>
+	auto raise(const basic_cube<W>& c, const size_t j) -> basic_cube<W> {
+		var_set<W> bit = {};
+		bit[j / 64] = std::uint64_t(1) << (j % 64);
+		return raise(c, bit);
+	}
+
+	/**
+	Половина куба c, в которой переменная j (в c - '-') равна value
+	*/
+	template <std::size_t W>
+	auto half(const basic_cube<W>& c, const size_t j, const bool value) -> basic_cube<W> {
+		std::uint64_t values[W], mask[W];
+		for (std::size_t w = 0; w < W; ++w) {
+			values[w] = c.value(w);
+			mask[w] = c.mask(w);
+		}
+		const auto bit = std::uint64_t(1) << (j % 64);
+		mask[j / 64] &= ~bit;
+		if (value)
+			values[j / 64] |= bit;
+		return basic_cube<W>::from_words(values, mask);
+	}
+
+	/**
+	Количество '-' в кубе среди переменных all
+	*/
+	template <std::size_t W>
+	auto size(const basic_cube<W>& c, const var_set<W>& all) -> size_t {
+		size_t res = 0;
+		for (std::size_t w = 0; w < W; ++w)
+			res += bits::popcount(c.mask(w) & all[w]);
+		return res;
+	}
+}
+
+/**
+Конструктор \n
+Сложность \f$O(d)\f$, где \f$d\f$ - количество неопределенных наборов
+\param[in]		vars		Количество переменных (не больше 64 * W)
+\param[in]		dont_cares	Неопределенные наборы (кубы)
+\throw			logic_error	Исключение, если переменных больше 64 * W
+*/
+template <std::size_t W>
+basic_espresso<W>::basic_espresso(const size_t vars, const std::vector<cube_type>& dont_cares)
+	: vars_(vars),
+	dont_cares_(dont_cares) {
+	if (vars > cube_type::max_vars)
+		throw std::logic_error("Too many variables.");
+	for (std::size_t w = 0; w < W; ++w) {
+		const auto bits = vars > 64 * w ? vars - 64 * w : 0;
+		all_[w] = bits >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1;
+	}
+}
+
+/**
+Лежит ли куб c в объединении кубов f (кроме f[skip]) и неопределенных наборов.
+Строится кофактор по c: кубы, пересекающиеся с c, с '-' на заданных в c позициях \n
+Сложность - линейная по \f$|f| + d\f$ плюс проверка тождественной истинности
+\param[in]		f			Покрытие
+\param[in]		skip		Номер куба, который не учитывается (f.size() - учитываются все)
+\param[in]		c			Проверяемый куб
+*/
+template <std::size_t W>
+auto basic_espresso<W>::contains(const std::vector<cube_type>& f, const size_t skip, const cube_type& c) const -> bool {
+	const auto given = fixed(c, all_);
+	std::vector<cube_type> g;
+	auto add = [&](const cube_type& x) {
+		if (empty(conflicts(x, c)))
+			g.push_back(raise(x, given));
+	};
+	for (size_t i = 0; i < f.size(); ++i)
+		if (i != skip)
+			add(f[i]);
+	for (const auto& x : dont_cares_)
+		add(x);
+	var_set free;
+	for (std::size_t w = 0; w < W; ++w)
+		free[w] = c.mask(w) & all_[w];
+	return tautology(std::move(g), free);
+}
+
+/**
+Покрывают ли кубы g все наборы (по переменным free; остальные у всех кубов '-').
+Монотонные переменные отбрасываются: если переменная встречается только без отрицания
+(или только с ним), то g тождественно истинно тогда и только тогда, когда истинны кубы,
+в которых ее нет. Иначе разложение по бинарной переменной, встречающейся чаще всего \n
+Сложность в худшем случае экспоненциальная по количеству переменных
+\param[in]		g			Кубы
+\param[in]		free		Переменные, по которым еще идет проверка
+*/
+template <std::size_t W>
+auto basic_espresso<W>::tautology(std::vector<cube_type> g, var_set free) const -> bool {
+	while (true) {
+		if (g.empty())
+			return false;
+		var_set pos = {}, neg = {};
+		for (const auto& x : g) {
+			std::uint64_t any = 0;
+			for (std::size_t w = 0; w < W; ++w) {
+				const auto given = ~x.mask(w) & free[w];
+				any |= given;
+				pos[w] |= x.value(w) & given;
+				neg[w] |= ~x.value(w) & given;
+			}
+			if (any == 0)
+				return true;
+		}
+		// Объем: если кубы вместе содержат меньше наборов, чем их всего, истинности нет
+		const auto k = count(free);
+		if (k < 63) {
+			std::uint64_t volume = 0;
+			const auto total = std::uint64_t(1) << k;
+			for (const auto& x : g) {
+				volume += std::uint64_t(1) << size(x, free);
+				if (volume >= total)
+					break;
+			}
+			if (volume < total)
+				return false;
+		}
+		var_set unate;
+		for (std::size_t w = 0; w < W; ++w)
+			unate[w] = pos[w] ^ neg[w];
+		if (!empty(unate)) {
+			g.erase(std::remove_if(g.begin(), g.end(), [&unate](const cube_type& x) {
+				return !empty(fixed(x, unate));
+			}), g.end());
+			for (std::size_t w = 0; w < W; ++w)
+				free[w] &= ~unate[w];
+			continue;
+		}
+		// Все оставшиеся переменные бинарные, разложение по самой частой
+		std::vector<size_t> occurs(64 * W, 0);
+		for (const auto& x : g)
+			for_each_var(fixed(x, free), [&occurs](size_t j) { ++occurs[j]; });
+		const auto j = static_cast<size_t>(std::max_element(occurs.begin(), occurs.end()) - occurs.begin());
+		std::vector<cube_type> g0, g1;
+		for (const auto& x : g) {
+			const auto y = raise(x, j);
+			const auto dash = has(x.mask(j / 64), j);
+			if (dash || !has(x.value(j / 64), j))
+				g0.push_back(y);
+			if (dash || has(x.value(j / 64), j))
+				g1.push_back(y);
+		}
+		free[j / 64] &= ~(std::uint64_t(1) << (j % 64));
+		return tautology(std::move(g0), free) && tautology(std::move(g1), free);
+	}
+}
+
+/**
+EXPAND: каждый куб (начиная с больших) расширяется до простого - переменные убираются
+по одной, пока куб остается в покрытии. Первыми пробуются переменные, по которым
+с кубом конфликтует больше всего еще не покрытых кубов (на расстоянии 1).
+Кубы, попавшие внутрь расширенного, выбрасываются \n
+Сложность \f$O(p \cdot n \cdot (|f| + d))\f$ плюс проверки тождественной истинности,
+где \f$p\f$ - количество полученных кубов, \f$n\f$ - количество переменных
+\param[in]		f			Покрытие
+*/
+template <std::size_t W>
+auto basic_espresso<W>::expand(std::vector<cube_type>& f) const -> void {
+	const auto& all = all_;
+	std::stable_sort(f.begin(), f.end(), [&all](const cube_type& x, const cube_type& y) {
+		return size(x, all) > size(y, all);
+	});
+	std::vector<char> covered(f.size(), 0);
+	std::vector<size_t> weight(64 * W);
+	std::vector<size_t> order;
+	for (size_t i = 0; i < f.size(); ++i) {
+		if (covered[i])
+			continue;
+		auto c = f[i];
+		std::fill(weight.begin(), weight.end(), 0);
+		for (size_t k = 0; k < f.size(); ++k) {
+			if (covered[k] || k == i)
+				continue;
+			const auto diff = conflicts(f[k], c);
+			if (count(diff) == 1)
+				for_each_var(diff, [&weight](size_t j) { ++weight[j]; });
+		}
+		order.clear();
+		for_each_var(fixed(c, all_), [&order](size_t j) { order.push_back(j); });
+		std::stable_sort(order.begin(), order.end(), [&weight](size_t x, size_t y) {
+			return weight[x] > weight[y];
+		});
+		for (const auto j : order) {
+			const auto raised = raise(c, j);
+			// f[i] лежит внутри c, так что f само по себе все еще задает функцию
+			if (contains(f, f.size(), raised))
+				c = raised;
+		}
+		f[i] = c;
+		for (size_t k = 0; k < f.size(); ++k)
+			if (k != i && !covered[k] && c.covers(f[k]))
+				covered[k] = 1;
+	}
+	size_t n = 0;
+	for (size_t i = 0; i < f.size(); ++i)
+		if (!covered[i])
+			f[n++] = f[i];
+	f.resize(n);
+}
+
+/**
+IRREDUNDANT: кубы (начиная с меньших) выбрасываются, если они лежат в остальных кубах
+и неопределенных наборах \n
+Сложность \f$O(|f| \cdot (|f| + d))\f$ плюс проверки тождественной истинности
+\param[in]		f			Покрытие
+*/
+template <std::size_t W>
+auto basic_espresso<W>::irredundant(std::vector<cube_type>& f) const -> void {
+	const auto& all = all_;
+	std::stable_sort(f.begin(), f.end(), [&all](const cube_type& x, const cube_type& y) {
+		return size(x, all) < size(y, all);
+	});
+	for (size_t i = 0; i < f.size();) {
+		if (contains(f, i, f[i]))
+			f.erase(f.begin() + i);
+		else
+			++i;
+	}
+}
+
+/**
+REDUCE: каждый куб (начиная с больших) сужается - по каждой отсутствующей переменной
+проверяется, лежит ли одна из половин куба в остальных кубах; если да, куб заменяется
+другой половиной. Покрытие при этом не меняется, а EXPAND потом может расширить куб
+в другую сторону \n
+Сложность \f$O(|f| \cdot n \cdot (|f| + d))\f$ плюс проверки тождественной истинности
+\param[in]		f			Покрытие
+*/
+template <std::size_t W>
+auto basic_espresso<W>::reduce(std::vector<cube_type>& f) const -> void {
+	const auto& all = all_;
+	std::stable_sort(f.begin(), f.end(), [&all](const cube_type& x, const cube_type& y) {
+		return size(x, all) > size(y, all);
+	});
+	for (size_t i = 0; i < f.size(); ++i) {
+		auto c = f[i];
+		var_set free;
+		for (std::size_t w = 0; w < W; ++w)
+			free[w] = c.mask(w) & all_[w];
+		for_each_var(free, [&](size_t j) {
+			const auto half0 = half(c, j, false);
+			const auto half1 = half(c, j, true);
+			if (contains(f, i, half0))
+				c = half1;
+			else if (contains(f, i, half1))
+				c = half0;
+		});
+		f[i] = c;
+	}
+}
+
+/**
+Количество литералов в покрытии - второй критерий качества после количества кубов \n
+Сложность \f$O(|f|)\f$
+*/
+template <std::size_t W>
+auto basic_espresso<W>::literals(const std::vector<cube_type>& f) const -> size_t {
+	size_t res = 0;
+	for (const auto& c : f)
+		res += vars_ - size(c, all_);
+	return res;
+}
+
+/**
+Минимизирует функцию: EXPAND и IRREDUNDANT, затем REDUCE, EXPAND и IRREDUNDANT,
+пока уменьшается количество кубов (или, при равном количестве, литералов),
+но не больше iterations раз \n
+Сложность - iterations раз сложность одного прохода
+\param[in]		ones		Единицы функции (наборы или кубы)
+\param[in]		iterations	Максимальное количество проходов REDUCE-EXPAND-IRREDUNDANT
+\param[out]		best		Лучшее из полученных покрытий, все кубы простые
+*/
+template <std::size_t W>
+auto basic_espresso<W>::minimize(const std::vector<cube_type>& ones, const size_t iterations) const -> std::vector<cube_type> {
+	auto f = ones;
+	expand(f);
+	irredundant(f);
+	auto best = f;
+	for (size_t it = 0; it < iterations; ++it) {
+		reduce(f);
+		expand(f);
+		irredundant(f);
+		if (f.size() < best.size() || (f.size() == best.size() && literals(f) < literals(best)))
+			best = f;
+		else
+			break;
+	}
+	std::sort(best.begin(), best.end());
+	return best;
+}
+
+template class basic_espresso<1>;
+template class basic_espresso<2>;
@@ -12,26 +12,13 @@
 \param[in] type		Тип узла
 \param[in] data		Данные узла
 */
-log_expr::exp_node::exp_node(exp_node* prev, exp_type type, size_t data)
+log_expr::exp_node::exp_node(size_t prev, exp_type type, size_t data)
 	: prev(prev),
 	type(type),
 	data(data),
-	first(nullptr),
+	first(no_node),
 	operation(op_null),
-	second(nullptr) {}
-
-/**
-Конструктор копирования, что тут еще сказать? \n
-Сложность \f$O(1)\f$
-\param[in] o		Узел для копирования
-*/
-log_expr::exp_node::exp_node(const exp_node& o)
-	: prev(o.prev),
-	type(o.type),
-	data(o.data),
-	first(o.first),
-	operation(o.operation),
-	second(o.second) {}
+	second(no_node) {}
 
 /**
 Нужен для определения стадии парсинга. В соответствии с стадией выкидываются исключения, означающие ошибки в процессе парсинга \n
@@ -46,65 +33,40 @@ log_expr::exp_node::exp_node(const exp_node& o)
 */
 auto log_expr::exp_node::state() const -> size_t {
 	if (!operation) {
-		if (!first)
+		if (first == no_node)
 			return 0;
 		return 1;
 	}
-	if (!second)
+	if (second == no_node)
 		return 2;
 	return 3;
 }
 
 /**
-Принимает булев вектор того же размера, что и вектор идентификаторов и рекурсивно получает значение выражения (формулы) \n
-Сложность \f$O(V + E)\f$, где \f$V\f$ - количество вершин, 
-\f$E\f$ - количество ребер
-\param[out]		bool	значение функции на наборе переменных
-*/
-auto log_expr::exp_node::process(std::vector<bool>& inps) const -> bool {
-	switch (type) {
-	case e_root:
-	case e_node:
-	case e_subnode: {
-
-		switch (operation) {
-		case op_and:
-			return first->process(inps) & second->process(inps);
-		case op_or:
-			return first->process(inps) | second->process(inps);
-		case op_not:
-			return !second->process(inps);
-		case op_null:
-			return first->process(inps);
-		}
-		break;
-	}
-
-	case e_leaf:
-		return inps[data];
-
-	}
-	throw std::logic_error("unreachable section");
-}
-
-/**
-Деструктор. Ну тут ничего необычного, простое освобождение памяти, выделенной в exp_node \n
-Сложность \f$O(1)\f$
+Добавляет узел в арену nodes_. Ссылки на узлы после этого могут стать недействительными,
+поэтому везде используются номера \n
+Сложность \f$O(1)\f$ (амортизированно)
+\param[in] prev		Предыдущий узел
+\param[in] type		Тип узла
+\param[in] data		Данные узла
+\param[out] res		Номер нового узла
 */
-log_expr::exp_node::~exp_node() {
-	delete first;
-	delete second;
+auto log_expr::add_node(size_t prev, exp_type type, size_t data) -> size_t {
+	nodes_.emplace_back(prev, type, data);
+	return nodes_.size() - 1;
 }
 
 /**
-Конструктор, строит дерево по переданной строке \n
+Конструктор, строит дерево по переданной строке. Узлы выделяются в арене nodes_,
+так что разбор не обращается к куче на каждый узел, а дерево освобождается целиком \n
 Сложность \f$O(n)\f$, где \f$n\f$ - длина входной строки
 \param[in]	str	Строка для разбора
 */
 log_expr::log_expr(const std::string& str) {
 	std::stringstream ss(str);
-	root_ = new exp_node(nullptr, e_root);
-	exp_node* cur = root_;
+	nodes_.reserve(str.size() + 1);
+	const auto root = add_node(no_node, e_root);
+	auto cur = root;
 	size_t i;
 	for (i = 0; ss; ++i) {
 		char c = ss.get();
@@ -119,67 +81,68 @@ log_expr::log_expr(const std::string& str) {
 				t = op_and;
 			else
 				t = op_or;
-			if ((cur->state() == 0) || (cur->state() == 2))
+			if ((nodes_[cur].state() == 0) || (nodes_[cur].state() == 2))
 				throw std::runtime_error("Variable missing at position " + std::to_string(i));
-			if (cur->state() == 1)
-				cur->operation = t;
-			else if (cur->state() == 3) {
+			if (nodes_[cur].state() == 1)
+				nodes_[cur].operation = t;
+			else if (nodes_[cur].state() == 3) {
 				if (t == op_or) {
-					exp_node* temp = new exp_node(*cur);
-					cur->first = temp;
-					temp->prev = cur;
-					cur->operation = t;
-					cur->second = nullptr;
+					nodes_.push_back(nodes_[cur]);
+					const auto temp = nodes_.size() - 1;
+					nodes_[temp].prev = cur;
+					nodes_[cur].first = temp;
+					nodes_[cur].operation = t;
+					nodes_[cur].second = no_node;
 				}
 				else {
-					exp_node* temp = new exp_node(cur, e_leaf, cur->second->data);
-					cur = cur->second;
-					cur->first = temp;
-					cur->operation = t;
-					cur->type = e_node;
+					const auto temp = add_node(cur, e_leaf, nodes_[nodes_[cur].second].data);
+					cur = nodes_[cur].second;
+					nodes_[cur].first = temp;
+					nodes_[cur].operation = t;
+					nodes_[cur].type = e_node;
 				}
 			}
 			break;
 		}
 		case '!': {
-			if ((cur->state() == 1) || (cur->state() == 3))
+			if ((nodes_[cur].state() == 1) || (nodes_[cur].state() == 3))
 				throw std::runtime_error("Operator missing at position " + std::to_string(i));
-			if (cur->operation == op_not)
+			if (nodes_[cur].operation == op_not)
 				throw std::runtime_error("Double negage at position " + std::to_string(i));
-			exp_node* temp = new exp_node(cur, e_node);
-			temp->operation = op_not;
-			if (cur->state() == 0) {
-				cur->first = temp;
-				cur = cur->first;
+			const auto temp = add_node(cur, e_node);
+			nodes_[temp].operation = op_not;
+			if (nodes_[cur].state() == 0) {
+				nodes_[cur].first = temp;
+				cur = temp;
 			}
-			else if (cur->state() == 2) {
-				cur->second = temp;
-				cur = cur->second;
+			else if (nodes_[cur].state() == 2) {
+				nodes_[cur].second = temp;
+				cur = temp;
 			}
 			break;
 		}
 		case '(': {
-			if ((cur->state() == 1) || (cur->state() == 3))
+			if ((nodes_[cur].state() == 1) || (nodes_[cur].state() == 3))
 				throw std::runtime_error("Operator missing at position " + std::to_string(i));
-			exp_node* temp = new exp_node(cur, e_subnode);
-			if (cur->state() == 0) {
-				cur->first = temp;
-				cur = cur->first;
+			const auto temp = add_node(cur, e_subnode);
+			if (nodes_[cur].state() == 0) {
+				nodes_[cur].first = temp;
+				cur = temp;
 			}
-			else if (cur->state() == 2) {
-				cur->second = temp;
-				cur = cur->second;
+			else if (nodes_[cur].state() == 2) {
+				nodes_[cur].second = temp;
+				cur = temp;
 			}
 			break;
 		}
 		case ')': {
-			while ((cur->type != e_subnode) && (cur->type != e_root))
-				cur = cur->prev;
-			if (cur->type == e_root)
+			while ((nodes_[cur].type != e_subnode) && (nodes_[cur].type != e_root))
+				cur = nodes_[cur].prev;
+			if (nodes_[cur].type == e_root)
 				throw std::runtime_error("Left bracket not found at position " + std::to_string(i));
-			cur = cur->prev;
-			if (cur->operation == op_not)
-				cur = cur->prev;
+			cur = nodes_[cur].prev;
+			if (nodes_[cur].operation == op_not)
+				cur = nodes_[cur].prev;
 			break;
 		}
 		case ' ':
@@ -210,46 +173,218 @@ log_expr::log_expr(const std::string& str) {
 				idind = ids_.size();
 				ids_.push_back(id);
 			}
-			if ((cur->state() == 3) || (cur->state() == 1))
+			if ((nodes_[cur].state() == 3) || (nodes_[cur].state() == 1))
 				throw std::runtime_error("Operator missing at position " + std::to_string(i));
-			exp_node* temp = new exp_node(cur, e_leaf, idind);
-			if (cur->state() == 2)
-				cur->second = temp;
-			else if (cur->state() == 0)
-				cur->first = temp;
-			if (cur->operation == op_not)
-				cur = cur->prev;
+			const auto temp = add_node(cur, e_leaf, idind);
+			if (nodes_[cur].state() == 2)
+				nodes_[cur].second = temp;
+			else if (nodes_[cur].state() == 0)
+				nodes_[cur].first = temp;
+			if (nodes_[cur].operation == op_not)
+				cur = nodes_[cur].prev;
 		}
 		}
 	}
-	while ((cur->type != e_subnode) && (cur->type != e_root))
-		cur = cur->prev;
-	if (cur->type == e_subnode)
+	while ((nodes_[cur].type != e_subnode) && (nodes_[cur].type != e_root))
+		cur = nodes_[cur].prev;
+	if (nodes_[cur].type == e_subnode)
 		throw std::runtime_error("Right bracket not found at position " + std::to_string(i));
+	if (nodes_[root].first != no_node)
+		compile();
 }
 
 /**
-Вывод полученного из логического выражения в поток os \n
-Сложность \f$O(1)\f$
+Переводит дерево в постфиксную запись (code_) и считает нужную глубину стека.
+Обход идет по явному стеку, так что глубокая вложенность скобок не переполняет стек вызовов \n
+Сложность \f$O(V)\f$, где \f$V\f$ - количество вершин дерева
+\throw	runtime_error	Исключение, если у операции не хватает операнда
+*/
+auto log_expr::compile() -> void {
+	/**
+	Узел, сколько ячеек стека будет занято после его вычисления и сколько операндов уже обработано
+	*/
+	struct frame {
+		size_t node;
+		size_t height;
+		size_t stage;
+	};
+	std::vector<frame> todo;
+	todo.push_back({ 0, 1, 0 });
+	while (!todo.empty()) {
+		auto& f = todo.back();
+		depth_ = std::max(depth_, f.height);
+		if (f.node == no_node)
+			throw std::runtime_error("Variable missing at the end of expression");
+		const auto& node = nodes_[f.node];
+		if (node.type == e_leaf) {
+			code_.push_back({ op_null, node.data });
+			todo.pop_back();
+			continue;
+		}
+		const auto height = f.height;
+		switch (node.operation) {
+		case op_and:
+		case op_or:
+			if (f.stage == 0) {
+				f.stage = 1;
+				todo.push_back({ node.first, height, 0 });
+			}
+			else if (f.stage == 1) {
+				f.stage = 2;
+				todo.push_back({ node.second, height + 1, 0 });
+			}
+			else {
+				code_.push_back({ node.operation, 0 });
+				todo.pop_back();
+			}
+			break;
+		case op_not:
+			if (f.stage == 0) {
+				f.stage = 1;
+				todo.push_back({ node.second, height, 0 });
+			}
+			else {
+				code_.push_back({ op_not, 0 });
+				todo.pop_back();
+			}
+			break;
+		case op_null: {
+			// Узел без операции просто заменяется своим операндом
+			const auto first = node.first;
+			todo.pop_back();
+			todo.push_back({ first, height, 0 });
+			break;
+		}
+		}
+	}
+}
+
+/**
+Вычисляет формулу сразу на 64 наборах с номерами от 64 * word до 64 * word + 63.
+Переменная с номером k < 6 на этих наборах дает периодическую маску, а переменная
+с номером k >= 6 постоянна и равна биту (k - 6) числа word \n
+Сложность \f$O(L)\f$, где \f$L\f$ - длина постфиксной записи
+\param[in]	word	Номер группы из 64 наборов
+\param[in]	stack	Стек размера depth_ (чтобы не выделять память на каждом вызове)
+\param[out]	res		Бит i - значение функции на наборе 64 * word + i
+*/
+auto log_expr::eval(const size_t word, std::vector<std::uint64_t>& stack) const -> std::uint64_t {
+	static const std::uint64_t patterns[] = {
+		0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+		0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+	};
+	size_t top = 0;
+	for (const auto& i : code_) {
+		switch (i.operation) {
+		case op_null:
+			stack[top++] = i.data < 6 ? patterns[i.data] : (((word >> (i.data - 6)) & 1) ? ~std::uint64_t(0) : 0);
+			break;
+		case op_not:
+			stack[top - 1] = ~stack[top - 1];
+			break;
+		case op_and:
+			--top;
+			stack[top - 1] &= stack[top];
+			break;
+		case op_or:
+			--top;
+			stack[top - 1] |= stack[top];
+			break;
+		}
+	}
+	return stack[0];
+}
+
+/**
+Вывод полученного из логического выражения вектора значений в поток os. Символ с номером p -
+значение на наборе, где переменная ids[k] равна k-му биту числа p. Формула вычисляется
+по постфиксной записи сразу на 64 наборах \n
+Сложность \f$O(2^n \cdot L / 64)\f$, где \f$n\f$ - количество переменных,
+\f$L\f$ - длина постфиксной записи
 \param[in]	os	Поток вывода
+\throw	runtime_error	Исключение, если выражение пустое или переменных больше 63
 */
 auto log_expr::print(std::ostream& os) const -> void {
-	std::vector<bool> vals(ids_.size(), false);
-	while (true) {
-		os << root_->process(vals);
-		size_t i;
-		for (i = 0; (i < vals.size()) && vals[i]; ++i)
-			vals[i] = false;
-		if (i == vals.size())
-			break;
-		vals[i] = true;
+	if (code_.empty())
+		throw std::runtime_error("Expression is empty");
+	if (ids_.size() > 63)
+		throw std::runtime_error("Too many variables");
+	const auto total = std::uint64_t(1) << ids_.size();
+	std::vector<std::uint64_t> stack(depth_);
+	char buf[64];
+	for (std::uint64_t word = 0; word * 64 < total; ++word) {
+		const auto x = eval(word, stack);
+		const auto n = std::min<std::uint64_t>(64, total - word * 64);
+		for (size_t i = 0; i < n; ++i)
+			buf[i] = ((x >> i) & 1) ? '1' : '0';
+		os.write(buf, n);
 	}
 }
 
 /**
-Деструктор. Здесь тоже ничего необычного, простое освобождение памяти, выделенной в под root_ \n
-Сложность \f$O(1)\f$
+Номера наборов, на которых формула равна единице, в порядке возрастания. Нумерация та же,
+что и у символов вектора из print, но сам вектор не строится - подходит для передачи
+прямо в Quine_McCluskey_Simplifier::init \n
+Сложность \f$O(2^n \cdot L / 64 + k)\f$, где \f$n\f$ - количество переменных,
+\f$L\f$ - длина постфиксной записи, \f$k\f$ - количество единиц
+\param[out]	res		Номера наборов
+\throw	runtime_error	Исключение, если выражение пустое или переменных больше 63
 */
-log_expr::~log_expr() {
-	delete root_;
-}
\ No newline at end of file
+auto log_expr::minterms() const -> std::vector<std::uint64_t> {
+	if (code_.empty())
+		throw std::runtime_error("Expression is empty");
+	if (ids_.size() > 63)
+		throw std::runtime_error("Too many variables");
+	const auto total = std::uint64_t(1) << ids_.size();
+	std::vector<std::uint64_t> stack(depth_);
+	std::vector<std::uint64_t> res;
+	for (std::uint64_t word = 0; word * 64 < total; ++word) {
+		auto x = eval(word, stack);
+		if (total - word * 64 < 64)
+			x &= (std::uint64_t(1) << (total - word * 64)) - 1;
+		for (; x != 0; x &= x - 1)
+			res.push_back(word * 64 + bits::lowest(x));
+	}
+	return res;
+}
+
+/**
+Строит диаграмму решений формулы по постфиксной записи: переменная ids[k] - переменная k
+диаграммы, т.е. бит k номера набора, как и в minterms. Наборы не перебираются, так что
+формулы с большим количеством переменных, но небольшой диаграммой, строятся быстро \n
+Сложность - \f$L\f$ операций ITE, где \f$L\f$ - длина постфиксной записи
+\param[in]	manager	Менеджер диаграмм, переменных в нем не меньше, чем в формуле
+\param[out]	res		Номер корня диаграммы в manager
+\throw	runtime_error	Исключение, если выражение пустое или в manager не хватает переменных
+*/
+auto log_expr::to_bdd(bdd& manager) const -> size_t {
+	if (code_.empty())
+		throw std::runtime_error("Expression is empty");
+	if (ids_.size() > manager.variables())
+		throw std::runtime_error("Too many variables");
+	std::vector<size_t> stack;
+	stack.reserve(depth_);
+	for (const auto& i : code_) {
+		switch (i.operation) {
+		case op_null:
+			stack.push_back(manager.variable(i.data));
+			break;
+		case op_not:
+			stack.back() = manager.negate(stack.back());
+			break;
+		case op_and: {
+			const auto second = stack.back();
+			stack.pop_back();
+			stack.back() = manager.conj(stack.back(), second);
+			break;
+		}
+		case op_or: {
+			const auto second = stack.back();
+			stack.pop_back();
+			stack.back() = manager.disj(stack.back(), second);
+			break;
+		}
+		}
+	}
+	return stack[0];
+}
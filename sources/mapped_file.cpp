@@ -0,0 +1,89 @@
+#include "mapped_file.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//////////////////////////////////////////////
+//                                          //
+//               mapped_file                //
+//                                          //
+//////////////////////////////////////////////
+
+/**
+Конструктор. Открывает файл и отображает его в память \n
+Сложность \f$O(1)\f$ (страницы подгружаются при первом обращении)
+\param[in]		file_name	Имя файла
+\throw			logic_error	Исключение, если файл не был открыт или не отобразился
+*/
+#if defined(_WIN32)
+mapped_file::mapped_file(const std::string& file_name) {
+	file_ = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file_ == INVALID_HANDLE_VALUE) {
+		file_ = nullptr;
+		throw std::logic_error("File not opened.");
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file_, &size)) {
+		CloseHandle(file_);
+		throw std::logic_error("File not opened.");
+	}
+	size_ = static_cast<size_t>(size.QuadPart);
+	if (size_ == 0)
+		return;
+	mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_ != nullptr)
+		data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+	if (data_ == nullptr) {
+		if (mapping_ != nullptr)
+			CloseHandle(mapping_);
+		CloseHandle(file_);
+		throw std::logic_error("File not mapped.");
+	}
+}
+
+mapped_file::~mapped_file() {
+	if (data_ != nullptr)
+		UnmapViewOfFile(data_);
+	if (mapping_ != nullptr)
+		CloseHandle(mapping_);
+	if (file_ != nullptr)
+		CloseHandle(file_);
+}
+#else
+mapped_file::mapped_file(const std::string& file_name) {
+	const auto fd = ::open(file_name.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw std::logic_error("File not opened.");
+	struct stat st;
+	if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+		::close(fd);
+		throw std::logic_error("File not opened.");
+	}
+	size_ = static_cast<size_t>(st.st_size);
+	if (size_ == 0) {
+		::close(fd);
+		return;
+	}
+	auto p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	// Отображение держит файл само, дескриптор больше не нужен
+	::close(fd);
+	if (p == MAP_FAILED)
+		throw std::logic_error("File not mapped.");
+#if defined(POSIX_MADV_SEQUENTIAL)
+	::posix_madvise(p, size_, POSIX_MADV_SEQUENTIAL);
+#endif
+	data_ = static_cast<const char*>(p);
+}
+
+mapped_file::~mapped_file() {
+	if (data_ != nullptr)
+		::munmap(const_cast<char*>(data_), size_);
+}
+#endif
@@ -0,0 +1,236 @@
+#include "multi_output_simplifier.hpp"
+
+//////////////////////////////////////////////
+//                                          //
+//         multi_output_simplifier          //
+//                                          //
+//////////////////////////////////////////////
+
+/**
+Функция-инициализатор объекта. Выход i задается outputs[i]. Количество переменных
+общее для всех выходов - длина двоичной записи наибольшего набора. Предыдущие функции заменяются \n
+Сложность \f$O(s \cdot log(s))\f$, где \f$s\f$ - общее количество наборов всех выходов
+\param[in] outputs		Функции выходов
+\throw	logic_error	Исключение, если выходов больше 64
+*/
+auto multi_output_simplifier::init(const std::vector<boolean_function>& outputs) -> void {
+	if (outputs.size() > 64)
+		throw std::logic_error("Too many outputs.");
+	ones_.assign(outputs.size(), std::vector<cube>());
+	sets_.clear();
+	implicants_.clear();
+	terms_.clear();
+	minimal_ = false;
+
+	// Пары (набор, выход) сортируются по набору, маски одинаковых наборов объединяются
+	std::vector<std::pair<std::uint64_t, std::uint64_t>> pairs;
+	std::uint64_t all = 0;
+	for (size_t i = 0; i < outputs.size(); ++i) {
+		for (const auto x : outputs[i].ones) {
+			pairs.emplace_back(x, std::uint64_t(1) << i);
+			ones_[i].push_back(cube(x));
+			all |= x;
+		}
+		for (const auto x : outputs[i].dont_cares) {
+			pairs.emplace_back(x, std::uint64_t(1) << i);
+			all |= x;
+		}
+		std::sort(ones_[i].begin(), ones_[i].end());
+		ones_[i].erase(std::unique(ones_[i].begin(), ones_[i].end()), ones_[i].end());
+	}
+	std::sort(pairs.begin(), pairs.end());
+	for (const auto& p : pairs) {
+		if (!sets_.empty() && sets_.back().set == cube(std::get<0>(p)))
+			sets_.back().outputs |= std::get<1>(p);
+		else
+			sets_.push_back({ cube(std::get<0>(p)), std::get<1>(p), false });
+	}
+	vars_ = pairs.empty() ? 0 : (all != 0 ? bits::highest(all) + 1 : 1);
+}
+
+/**
+Один раунд склейки: кубы упорядочены по весу и маске, склеиваются соседние по весу кубы
+с одинаковыми позициями '-' и пересекающимися масками выходов. Склеенный куб получает
+пересечение масок; исходный куб отмечается, если его маска сохранилась целиком.
+Повторы отбрасываются сразу (маска куба не зависит от того, из какой пары он получен) \n
+Сложность \f$O(\sum a_j \cdot b_j)\f$, где \f$a_j\f$ и \f$b_j\f$ - размеры соседних корзин
+\param[in]		cur			Кубы текущего раунда
+\param[in]		next		Куда дописывать склеенные кубы
+*/
+auto multi_output_simplifier::combine_round(std::vector<tagged_cube>& cur, std::vector<tagged_cube>& next) -> void {
+	auto less = [](const tagged_cube& x, const tagged_cube& y) {
+		const auto wx = x.set.weight(), wy = y.set.weight();
+		return wx != wy ? wx < wy : x.set.mask_less(y.set);
+	};
+	auto mask_less = [](const tagged_cube& x, const tagged_cube& y) {
+		return x.set.mask_less(y.set);
+	};
+	std::sort(cur.begin(), cur.end(), less);
+	cube_set merged;
+	// Начала групп одного веса
+	std::vector<size_t> starts;
+	for (size_t i = 0; i < cur.size(); ++i)
+		if (i == 0 || cur[i].set.weight() != cur[i - 1].set.weight())
+			starts.push_back(i);
+	starts.push_back(cur.size());
+	for (size_t g = 0; g + 2 < starts.size(); ++g) {
+		if (cur[starts[g]].set.weight() + 1 != cur[starts[g + 1]].set.weight())
+			continue;
+		for (auto a = starts[g]; a < starts[g + 1]; ++a) {
+			// Корзина с той же маской в следующей группе
+			auto b = std::lower_bound(cur.begin() + starts[g + 1], cur.begin() + starts[g + 2], cur[a], mask_less) - cur.begin();
+			for (; b < static_cast<std::ptrdiff_t>(starts[g + 2]) && cur[b].set.same_mask(cur[a].set); ++b) {
+				const auto outputs = cur[a].outputs & cur[b].outputs;
+				if (outputs == 0 || !cur[a].set.is_neighbor(cur[b].set))
+					continue;
+				if (outputs == cur[a].outputs)
+					cur[a].merged = true;
+				if (outputs == cur[b].outputs)
+					cur[b].merged = true;
+				const auto set = cur[a].set.merge(cur[b].set);
+				if (merged.insert(set))
+					next.push_back({ set, outputs, false });
+			}
+		}
+	}
+}
+
+/**
+Находит все простые кубы (с максимальными масками выходов), записывает их в implicants \n
+Сложность как у Quine_McCluskey_Simplifier::get_implicants
+*/
+auto multi_output_simplifier::get_implicants() -> void {
+	implicants_.clear();
+	auto cur = sets_;
+	std::vector<tagged_cube> next;
+	while (!cur.empty()) {
+		combine_round(cur, next);
+		for (const auto& i : cur)
+			if (!i.merged)
+				implicants_.push_back(i);
+		cur.swap(next);
+		next.clear();
+	}
+}
+
+/**
+Минимизирует все выходы вместе. Таблица покрытия сокращается (если options.reduce)
+и покрывается жадно или точно, как в Quine_McCluskey_Simplifier::simplify. Затем каждому
+выходу достаются выбранные кубы, которые покрывают хотя бы одну его единицу.
+Простые кубы ищутся только склейкой, поэтому options.engine должен быть e_quine_mccluskey,
+а кэш (options.cache) хранит результаты одной функции и здесь не поддерживается.
+В options.stats ядро не выделяется отдельно (core_ms и essential - 0, таблица одна,
+table_rows и table_cols - ее размер); terms - количество различных кубов \n
+Сложность \f$O(log(k) \cdot (k \cdot n^2) + r \cdot m)\f$, где \f$k\f$ - количество наборов,
+\f$n\f$ - количество переменных, \f$r\f$ - количество строк таблицы, \f$m\f$ - количество простых кубов
+\param[in]		options		Параметры минимизации
+\throw			logic_error	Исключение, если задан другой способ минимизации или кэш
+*/
+auto multi_output_simplifier::simplify(const simplify_options& options) -> void {
+	if (options.engine != e_quine_mccluskey)
+		throw std::logic_error("Only the Quine-McCluskey engine supports several outputs.");
+	if (options.cache)
+		throw std::logic_error("The result cache does not support several outputs.");
+	using clock = std::chrono::steady_clock;
+	const auto start = clock::now();
+	auto phase = start;
+	// Время с конца прошлой фазы
+	auto lap = [&phase]() {
+		const auto now = clock::now();
+		const auto res = std::chrono::duration<double, std::milli>(now - phase).count();
+		phase = now;
+		return res;
+	};
+	simplify_stats stats;
+	get_implicants();
+	stats.implicants_ms = lap();
+	stats.primes = implicants_.size();
+	// Строки таблицы - единицы выходов подряд, first[i] - первая строка выхода i
+	std::vector<size_t> first(ones_.size() + 1, 0);
+	for (size_t i = 0; i < ones_.size(); ++i)
+		first[i + 1] = first[i] + ones_[i].size();
+	cover_matrix table(first.back(), implicants_.size());
+	for (size_t i = 0; i < ones_.size(); ++i)
+		for (size_t r = 0; r < ones_[i].size(); ++r)
+			for (size_t j = 0; j < implicants_.size(); ++j)
+				if (((implicants_[j].outputs >> i) & 1) && implicants_[j].set.covers(ones_[i][r]))
+					table.set(first[i] + r, j);
+	stats.table_ms = lap();
+	stats.table_rows = table.rows();
+	stats.table_cols = table.cols();
+
+	cover_solver solver(table);
+	std::vector<size_t> chosen;
+	if (options.reduce)
+		chosen = solver.reduce();
+	stats.reduce_ms = lap();
+	stats.core_rows = solver.rows_left();
+	stats.core_cols = solver.cols_left();
+	std::vector<size_t> rest;
+	if (options.cover == c_exact) {
+		rest = solver.exact(options.node_limit, options.time_limit);
+		minimal_ = solver.optimal();
+	}
+	else {
+		rest = solver.greedy();
+		minimal_ = false;
+	}
+	stats.cover_ms = lap();
+	stats.reduce_picks = chosen.size();
+	stats.cover_picks = rest.size();
+	stats.nodes = solver.nodes();
+	chosen.insert(chosen.end(), rest.begin(), rest.end());
+
+	terms_.clear();
+	for (const auto j : chosen) {
+		std::uint64_t used = 0;
+		for (size_t i = 0; i < ones_.size(); ++i) {
+			for (auto r = first[i]; r < first[i + 1]; ++r) {
+				if (table.get(r, j)) {
+					used |= std::uint64_t(1) << i;
+					break;
+				}
+			}
+		}
+		terms_.emplace_back(implicants_[j].set, used);
+	}
+	std::sort(terms_.begin(), terms_.end());
+	if (options.stats) {
+		stats.terms = terms_.size();
+		stats.total_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+		*options.stats = stats;
+	}
+}
+
+/**
+МДНФ одного выхода - выбранные кубы, которые он использует \n
+Сложность \f$O(t)\f$, где \f$t\f$ - количество выбранных кубов
+\param[in]		output		Номер выхода
+\param[out]		res			Кубы в порядке print_mdnf
+*/
+auto multi_output_simplifier::mdnf(const size_t output) const -> std::vector<cube> {
+	std::vector<cube> res;
+	for (const auto& term : terms_)
+		if ((std::get<1>(term) >> output) & 1)
+			res.push_back(std::get<0>(term));
+	return res;
+}
+
+/**
+Печатает результат в виде PLA: по строке на куб - сам куб и через пробел строка выходов,
+где '1' на месте i означает, что выход i использует этот куб \n
+Сложность \f$O(t \cdot (n + o))\f$, где \f$t\f$ - количество кубов, \f$o\f$ - количество выходов
+\param[in]		os			Поток для печати
+\throw	logic_error	Кидает исключение, если минимизация не была произведена, а функция была вызвана
+*/
+auto multi_output_simplifier::print_mdnf(std::ostream& os) const -> void {
+	if (terms_.size() == 0)
+		throw std::logic_error("Minimization was not carried out");
+	for (const auto& term : terms_) {
+		std::string outputs(ones_.size(), '0');
+		for (size_t i = 0; i < ones_.size(); ++i)
+			if ((std::get<1>(term) >> i) & 1)
+				outputs[i] = '1';
+		os << std::get<0>(term).to_string(vars_) << " " << outputs << "\n";
+	}
+}
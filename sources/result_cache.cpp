@@ -0,0 +1,190 @@
+#include "result_cache.hpp"
+#include <algorithm>
+#include <sstream>
+
+//////////////////////////////////////////////
+//                                          //
+//               result_cache               //
+//                                          //
+//////////////////////////////////////////////
+
+namespace {
+	/**
+	Перемешивание слова (финализатор splitmix64)
+	*/
+	auto mix(std::uint64_t x) -> std::uint64_t {
+		x ^= x >> 30;
+		x *= 0xBF58476D1CE4E5B9ULL;
+		x ^= x >> 27;
+		x *= 0x94D049BB133111EBULL;
+		x ^= x >> 31;
+		return x;
+	}
+
+	/**
+	Шаг FNV-1a по байтам слова - второй хэш, независимый от mix
+	*/
+	auto fnv(std::uint64_t h, std::uint64_t x) -> std::uint64_t {
+		for (size_t i = 0; i < 8; ++i, x >>= 8) {
+			h ^= x & 0xFF;
+			h *= 0x100000001B3ULL;
+		}
+		return h;
+	}
+
+	/**
+	Добавляет слово в оба хэша ключа
+	*/
+	auto add(cache_key& key, const std::uint64_t x) -> void {
+		key.hash = mix(key.hash ^ x);
+		key.check = fnv(key.check, x);
+	}
+
+	/**
+	Добавляет кубы в ключ в порядке возрастания, так что порядок наборов во входе не важен
+	*/
+	auto add_cubes(cache_key& key, std::vector<cube> items) -> void {
+		std::sort(items.begin(), items.end());
+		items.erase(std::unique(items.begin(), items.end()), items.end());
+		add(key, items.size());
+		for (const auto& c : items) {
+			add(key, c.value(0));
+			add(key, c.mask(0));
+		}
+	}
+
+	/**
+	Контрольная сумма строки записи
+	*/
+	auto checksum(const std::string& line) -> std::uint64_t {
+		std::uint64_t h = 0xCBF29CE484222325ULL;
+		for (const auto c : line) {
+			h ^= static_cast<unsigned char>(c);
+			h *= 0x100000001B3ULL;
+		}
+		return h;
+	}
+}
+
+/**
+Конструктор, читает записи из файла (если он есть) и открывает его на дозапись.
+Строка принимается, только если ее контрольная сумма (последнее поле) сходится \n
+Сложность \f$O(L)\f$, где \f$L\f$ - размер файла
+\param[in]		file_name	Имя файла кэша
+\throw			logic_error	Исключение, если файл нельзя открыть на запись
+*/
+result_cache::result_cache(const std::string& file_name) {
+	std::ifstream in(file_name);
+	std::string line;
+	while (std::getline(in, line)) {
+		const auto last = line.rfind(' ');
+		if (last == std::string::npos)
+			continue;
+		std::uint64_t sum;
+		std::istringstream tail(line.substr(last + 1));
+		if (!(tail >> std::hex >> sum) || !tail.eof() || sum != checksum(line.substr(0, last)))
+			continue;
+		std::istringstream ss(line.substr(0, last));
+		std::uint64_t key;
+		size_t count, minimal;
+		entry e;
+		if (!(ss >> std::hex >> key >> e.check >> std::dec >> e.result.vars >> minimal >> count))
+			continue;
+		e.result.minimal = minimal != 0;
+		std::uint64_t value, mask;
+		char colon;
+		while (e.result.mdnf.size() < count && ss >> std::hex >> value >> colon >> mask && colon == ':')
+			e.result.mdnf.push_back(cube(value, mask));
+		if (e.result.mdnf.size() == count)
+			entries_[key] = e;
+	}
+	in.close();
+	file_.open(file_name, std::ios::app);
+	if (!file_.is_open())
+		throw std::logic_error("File not opened.");
+}
+
+/**
+Ключ кэша: два хэша версии, единиц и неопределенных наборов (без учета порядка и повторов),
+количества переменных и параметров, от которых зависит результат \n
+Сложность \f$O(k \cdot \log(k))\f$, где \f$k\f$ - количество наборов
+\param[in]		ones		Единицы функции
+\param[in]		dont_cares	Неопределенные наборы
+\param[in]		vars		Количество переменных
+\param[in]		options		Параметры минимизации (stats, cache и prime_limit не учитываются)
+\param[out]		res			Ключ
+*/
+auto result_cache::key(const std::vector<cube>& ones, const std::vector<cube>& dont_cares, const size_t vars, const simplify_options& options) -> cache_key {
+	cache_key res = { 0, 0xCBF29CE484222325ULL };
+	add(res, version);
+	add(res, vars);
+	add(res, options.engine);
+	if (options.engine != e_espresso) {
+		add(res, options.cover);
+		add(res, options.reduce);
+		if (options.cover == c_exact) {
+			add(res, options.node_limit);
+			add(res, static_cast<std::uint64_t>(options.time_limit.count()));
+		}
+	}
+	add_cubes(res, ones);
+	add_cubes(res, dont_cares);
+	return res;
+}
+
+/**
+Можно ли запоминать результат. Точный выбор покрытия, не успевший доказать минимальность,
+зависит от того, сколько перебор успел за отведенное время, поэтому такой результат
+не запоминается - иначе он остался бы в кэше навсегда \n
+Сложность \f$O(1)\f$
+\param[in]		options		Параметры минимизации
+\param[in]		result		Результат
+*/
+auto result_cache::cacheable(const simplify_options& options, const simplify_result& result) -> bool {
+	return options.engine == e_espresso || options.cover != c_exact || result.minimal;
+}
+
+/**
+Ищет запись с ключом key. Запись с тем же первым хэшем, но другим вторым не подходит \n
+Сложность \f$O(m)\f$ (в среднем), где \f$m\f$ - количество импликант в записи
+\param[in]		key			Ключ
+\param[in]		res			Куда записать найденный результат
+\param[out]		true/false	Найдена ли запись
+*/
+auto result_cache::find(const cache_key& key, simplify_result& res) const -> bool {
+	std::lock_guard<std::mutex> guard(lock_);
+	const auto it = entries_.find(key.hash);
+	if (it == entries_.end() || it->second.check != key.check)
+		return false;
+	res = it->second.result;
+	return true;
+}
+
+/**
+Добавляет запись и сразу дописывает ее в файл \n
+Сложность \f$O(m)\f$, где \f$m\f$ - количество импликант в записи
+\param[in]		key			Ключ
+\param[in]		result		Результат минимизации
+*/
+auto result_cache::insert(const cache_key& key, const simplify_result& result) -> void {
+	std::ostringstream line;
+	line << std::hex << key.hash << " " << key.check << std::dec << " " << result.vars << " " << result.minimal << " " << result.mdnf.size();
+	for (const auto& c : result.mdnf)
+		line << " " << std::hex << c.value(0) << ":" << c.mask(0);
+	const auto body = line.str();
+	std::ostringstream sum;
+	sum << std::hex << checksum(body);
+	std::lock_guard<std::mutex> guard(lock_);
+	entries_[key.hash] = { key.check, result };
+	file_ << body << " " << sum.str() << "\n";
+	file_.flush();
+}
+
+/**
+Количество записей \n
+Сложность \f$O(1)\f$
+*/
+auto result_cache::size() const -> size_t {
+	std::lock_guard<std::mutex> guard(lock_);
+	return entries_.size();
+}
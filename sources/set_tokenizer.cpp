@@ -0,0 +1,75 @@
+#include "set_tokenizer.hpp"
+
+//////////////////////////////////////////////
+//                                          //
+//              set_tokenizer               //
+//                                          //
+//////////////////////////////////////////////
+
+/**
+Пропускает разделители до следующей цифры, 'd' и перевод строки меняют признак dont_care \n
+Сложность \f$O(l)\f$, где \f$l\f$ - количество пройденных символов
+\param[out]	true/false	false, если номеров больше нет
+*/
+auto set_tokenizer::skip() -> bool {
+	for (; pos_ != last_; ++pos_) {
+		const auto c = *pos_;
+		if (c >= '0' && c <= '9')
+			break;
+		if (c == 'd')
+			dont_care_ = true;
+		else if (c == '\n')
+			dont_care_ = false;
+	}
+	return pos_ != last_;
+}
+
+/**
+Читает следующий номер набора. Разделители пропускаются, 'd' и перевод строки
+меняют признак dont_care \n
+Сложность \f$O(l)\f$, где \f$l\f$ - количество пройденных символов
+\param[in]	value		Куда записать номер
+\param[out]	true/false	false, если номеров больше нет
+\throw	logic_error	Исключение, если номер не помещается в 64 бита
+*/
+auto set_tokenizer::next(std::uint64_t& value) -> bool {
+	if (!skip())
+		return false;
+	const auto limit = UINT64_MAX / 10;
+	value = 0;
+	for (; pos_ != last_ && *pos_ >= '0' && *pos_ <= '9'; ++pos_) {
+		const auto digit = static_cast<std::uint64_t>(*pos_ - '0');
+		if (value > limit || (value == limit && digit > UINT64_MAX % 10))
+			throw std::logic_error("Too many variables.");
+		value = value * 10 + digit;
+	}
+	return true;
+}
+
+/**
+Читает следующий номер набора в count слов (младшее слово - первое), для номеров
+больше 64 бит. Каждая цифра - умножение на 10 с переносом по 32-битным половинам слов \n
+Сложность \f$O(l \cdot c)\f$, где \f$l\f$ - количество пройденных символов, \f$c\f$ - количество слов
+\param[in]	words		Куда записать номер
+\param[in]	count		Количество слов
+\param[out]	true/false	false, если номеров больше нет
+\throw	logic_error	Исключение, если номер не помещается в count слов
+*/
+auto set_tokenizer::next(std::uint64_t* words, const size_t count) -> bool {
+	if (!skip())
+		return false;
+	for (size_t w = 0; w < count; ++w)
+		words[w] = 0;
+	for (; pos_ != last_ && *pos_ >= '0' && *pos_ <= '9'; ++pos_) {
+		auto carry = static_cast<std::uint64_t>(*pos_ - '0');
+		for (size_t w = 0; w < count; ++w) {
+			const auto low = (words[w] & 0xFFFFFFFFULL) * 10 + carry;
+			const auto high = (words[w] >> 32) * 10 + (low >> 32);
+			words[w] = (high << 32) | (low & 0xFFFFFFFFULL);
+			carry = high >> 32;
+		}
+		if (carry != 0)
+			throw std::logic_error("Too many variables.");
+	}
+	return true;
+}
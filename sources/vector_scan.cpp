@@ -0,0 +1,96 @@
+#include "vector_scan.hpp"
+#include "cube.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define QMS_SCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define QMS_SCAN_SSE2
+#endif
+
+//////////////////////////////////////////////
+//                                          //
+//               vector_scan                //
+//                                          //
+//////////////////////////////////////////////
+
+namespace {
+	/**
+	Выписывает номера единичных битов маски, сдвинутые на base
+	*/
+	auto append_bits(std::uint64_t mask, const std::uint64_t base, std::vector<std::uint64_t>& out) -> void {
+		for (; mask != 0; mask &= mask - 1)
+			out.push_back(base + bits::lowest(mask));
+	}
+}
+
+/**
+Разбирает вектор значений: проверяет, что в нем только '0', '1' и '-', и дописывает
+номера позиций '1' в ones, а позиций '-' в dont_cares. Номера сдвигаются на base \n
+Сложность \f$O(n / B + k)\f$, где \f$n\f$ - длина вектора, \f$B\f$ - ширина блока (16 или 32),
+\f$k\f$ - количество выписанных номеров
+\param[in]	data		Символы вектора
+\param[in]	size		Длина вектора
+\param[in]	base		Номер первого символа
+\param[in]	ones		Куда дописывать номера единиц
+\param[in]	dont_cares	Куда дописывать номера неопределенных значений
+\param[out]	true/false	false, если встретился другой символ
+*/
+auto vector_scan::scan(const char* data, const size_t size, const std::uint64_t base,
+	std::vector<std::uint64_t>& ones, std::vector<std::uint64_t>& dont_cares) -> bool {
+	size_t i = 0;
+#if defined(QMS_SCAN_AVX2)
+	const auto zero = _mm256_set1_epi8('0');
+	const auto one = _mm256_set1_epi8('1');
+	const auto dash = _mm256_set1_epi8('-');
+	for (; i + 32 <= size; i += 32) {
+		const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+		const auto m1 = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, one)));
+		const auto md = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, dash)));
+		const auto m0 = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, zero)));
+		if ((m0 | m1 | md) != 0xFFFFFFFFu)
+			return false;
+		append_bits(m1, base + i, ones);
+		append_bits(md, base + i, dont_cares);
+	}
+#elif defined(QMS_SCAN_SSE2)
+	const auto zero = _mm_set1_epi8('0');
+	const auto one = _mm_set1_epi8('1');
+	const auto dash = _mm_set1_epi8('-');
+	for (; i + 16 <= size; i += 16) {
+		const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+		const auto m1 = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, one)));
+		const auto md = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, dash)));
+		const auto m0 = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, zero)));
+		if ((m0 | m1 | md) != 0xFFFFu)
+			return false;
+		append_bits(m1, base + i, ones);
+		append_bits(md, base + i, dont_cares);
+	}
+#endif
+	return scan_scalar(data + i, size - i, base + i, ones, dont_cares);
+}
+
+/**
+То же, что и scan, но посимвольно. Используется для хвоста вектора и там, где нет SSE2 \n
+Сложность \f$O(n)\f$, где \f$n\f$ - длина вектора
+*/
+auto vector_scan::scan_scalar(const char* data, const size_t size, const std::uint64_t base,
+	std::vector<std::uint64_t>& ones, std::vector<std::uint64_t>& dont_cares) -> bool {
+	for (size_t i = 0; i < size; ++i) {
+		switch (data[i]) {
+		case '0':
+			break;
+		case '1':
+			ones.push_back(base + i);
+			break;
+		case '-':
+			dont_cares.push_back(base + i);
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
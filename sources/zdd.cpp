@@ -0,0 +1,180 @@
+#include "zdd.hpp"
+#include <algorithm>
+
+//////////////////////////////////////////////
+//                                          //
+//                   zdd                    //
+//                                          //
+//////////////////////////////////////////////
+
+namespace {
+	/**
+	"Литерал" констант - больше всех настоящих литералов
+	*/
+	const size_t terminal = ~size_t(0);
+
+	/**
+	Операции для ключей кэша
+	*/
+	enum op_type { op_unite, op_difference };
+}
+
+/**
+Конструктор, создает константы \n
+Сложность \f$O(1)\f$
+*/
+zdd::zdd() {
+	nodes_.push_back({ terminal, empty, empty });
+	nodes_.push_back({ terminal, base, base });
+}
+
+/**
+Узел (var, low, high) - существующий, если такой уже есть, иначе новый.
+Если high пусто, литерал ни в одном кубе не встречается и узел не нужен \n
+Сложность \f$O(1)\f$ (в среднем)
+*/
+auto zdd::make(const size_t var, const size_t low, const size_t high) -> size_t {
+	if (high == empty)
+		return low;
+	const triple key = { var, low, high };
+	const auto it = unique_.find(key);
+	if (it != unique_.end())
+		return it->second;
+	nodes_.push_back({ var, low, high });
+	unique_.emplace(key, nodes_.size() - 1);
+	return nodes_.size() - 1;
+}
+
+/**
+Объединение семейств кубов \n
+Сложность \f$O(|p| \cdot |q|)\f$ в худшем случае
+*/
+auto zdd::unite(const size_t p, const size_t q) -> size_t {
+	if (p == empty || p == q)
+		return q;
+	if (q == empty)
+		return p;
+	const triple key = { std::min(p, q), std::max(p, q), op_unite };
+	const auto it = computed_.find(key);
+	if (it != computed_.end())
+		return it->second;
+	const auto a = nodes_[p], b = nodes_[q];
+	size_t res;
+	if (a.var < b.var)
+		res = make(a.var, unite(a.low, q), a.high);
+	else if (a.var > b.var)
+		res = make(b.var, unite(p, b.low), b.high);
+	else
+		res = make(a.var, unite(a.low, b.low), unite(a.high, b.high));
+	computed_.emplace(key, res);
+	return res;
+}
+
+/**
+Кубы из p, которых нет в q \n
+Сложность \f$O(|p| \cdot |q|)\f$ в худшем случае
+*/
+auto zdd::difference(const size_t p, const size_t q) -> size_t {
+	if (p == empty || p == q)
+		return empty;
+	if (q == empty)
+		return p;
+	const triple key = { p, q, op_difference };
+	const auto it = computed_.find(key);
+	if (it != computed_.end())
+		return it->second;
+	const auto a = nodes_[p], b = nodes_[q];
+	size_t res;
+	if (a.var < b.var)
+		res = make(a.var, difference(a.low, q), a.high);
+	else if (a.var > b.var)
+		res = difference(p, b.low);
+	else
+		res = make(a.var, difference(a.low, b.low), difference(a.high, b.high));
+	computed_.emplace(key, res);
+	return res;
+}
+
+/**
+Простые импликанты функции f с верхней переменной x: простые импликанты f0 * f1 (без x),
+простые импликанты f0, не лежащие в f1 (с отрицанием x), и простые импликанты f1,
+не лежащие в f0 (с x). Результат для каждого узла f запоминается в cache \n
+Сложность зависит от размеров диаграмм, а не от количества импликант
+\param[in]		manager		Менеджер диаграммы f
+\param[in]		f			Функция
+\param[in]		cache		Уже построенные семейства для узлов manager
+*/
+auto zdd::primes(bdd& manager, const size_t f, std::unordered_map<size_t, size_t>& cache) -> size_t {
+	if (f == bdd::zero)
+		return empty;
+	if (f == bdd::one)
+		return base;
+	const auto it = cache.find(f);
+	if (it != cache.end())
+		return it->second;
+	const auto var = manager.var(f);
+	const auto f0 = manager.low(f), f1 = manager.high(f);
+	const auto both = primes(manager, manager.conj(f0, f1), cache);
+	const auto neg = difference(primes(manager, f0, cache), both);
+	const auto pos = difference(primes(manager, f1, cache), both);
+	// Литерал 2 * var меньше литерала 2 * var + 1 и всех литералов остальных переменных
+	const auto res = make(2 * var, make(2 * var + 1, both, pos), neg);
+	cache.emplace(f, res);
+	return res;
+}
+
+/**
+Все простые импликанты функции f в виде ZDD (метод Кудера-Мадра) \n
+Сложность зависит от размеров диаграмм, а не от количества импликант
+\param[in]		manager		Менеджер диаграммы f
+\param[in]		f			Функция (вместе с неопределенными наборами)
+\param[out]		res			Семейство простых импликант
+*/
+auto zdd::primes(bdd& manager, const size_t f) -> size_t {
+	std::unordered_map<size_t, size_t> cache;
+	return primes(manager, f, cache);
+}
+
+/**
+Количество кубов в семействе (без их перечисления) \n
+Сложность \f$O(|p|)\f$ в среднем
+*/
+auto zdd::count(const size_t p) const -> std::uint64_t {
+	std::unordered_map<size_t, std::uint64_t> done;
+	done[empty] = 0;
+	done[base] = 1;
+	// Явный стек: узлы, у которых еще не посчитаны потомки, кладутся повторно
+	std::vector<size_t> todo(1, p);
+	while (!todo.empty()) {
+		const auto x = todo.back();
+		if (done.count(x)) {
+			todo.pop_back();
+			continue;
+		}
+		const auto low = done.find(nodes_[x].low), high = done.find(nodes_[x].high);
+		if (low != done.end() && high != done.end()) {
+			done[x] = low->second + high->second;
+			todo.pop_back();
+			continue;
+		}
+		if (low == done.end())
+			todo.push_back(nodes_[x].low);
+		if (high == done.end())
+			todo.push_back(nodes_[x].high);
+	}
+	return done[p];
+}
+
+/**
+Кубы семейства в порядке возрастания \n
+Сложность \f$O(c \cdot (n + \log(c)))\f$, где \f$c\f$ - количество кубов
+\param[in]		p			Семейство
+\param[in]		vars		Количество переменных
+\param[out]		res			Кубы
+*/
+auto zdd::cubes(const size_t p, const size_t vars) const -> std::vector<cube> {
+	std::vector<cube> res;
+	for_each(p, vars, [&res](const cube& c) { res.push_back(c); });
+	std::sort(res.begin(), res.end());
+	return res;
+}
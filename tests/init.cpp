@@ -1,7 +1,13 @@
 #include "Quine_McCluskey_Simplifier.hpp"
+#include "batch_simplifier.hpp"
+#include "multi_output_simplifier.hpp"
+#include "result_cache.hpp"
 #include "log_expr.hpp"
 #include "catch.hpp"
+#include <cmath>
+#include <cstdio>
 #include <fstream>
+#include <random>
 
 SCENARIO("QMS: ctor", "[ctor]") {
 	Quine_McCluskey_Simplifier test;
@@ -145,4 +151,1007 @@ SCENARIO("QMS: test sets 2", "[ts2]") {
 	QMS.print_mdnf(out);
 
 	REQUIRE(out.str() == (std::string)"---- ");
-}
\ No newline at end of file
+}
+
+SCENARIO("cube: string round trip and ordering", "[cube]") {
+	const auto a = cube::from_string("1-01");
+	const auto b = cube::from_string("0-01");
+
+	REQUIRE(a.to_string(4) == "1-01");
+	REQUIRE(cube(13).to_string(4) == "1101");
+	REQUIRE(a.weight() == 2);
+	REQUIRE(b < a);
+	REQUIRE(cube::from_string("-111") < b);
+	REQUIRE_THROWS_AS(cube::from_string(std::string(65, '1')), std::logic_error);
+}
+
+SCENARIO("cube: merge and cover", "[cube]") {
+	const auto a = cube::from_string("1101");
+	const auto b = cube::from_string("1111");
+
+	REQUIRE(a.is_neighbor(b));
+	REQUIRE_FALSE(a.is_neighbor(cube::from_string("1110")));
+	REQUIRE(a.merge(b).to_string(4) == "11-1");
+	REQUIRE(a.merge(b).covers(a));
+	REQUIRE(a.merge(b).covers(b));
+	REQUIRE_FALSE(a.covers(a.merge(b)));
+	REQUIRE(a.merge(b).same_mask(cube::from_string("00-0")));
+	REQUIRE(a.mask_less(a.merge(b)));
+	REQUIRE_FALSE(a.merge(b).mask_less(cube::from_string("10-1")));
+}
+
+SCENARIO("basic_cube: more than one word", "[cube]") {
+	const std::string s = "1" + std::string(70, '0') + "-1";
+	const auto a = basic_cube<2>::from_string(s);
+	const auto b = basic_cube<2>::from_string("1" + std::string(70, '0') + "01");
+
+	REQUIRE(a.to_string(s.size()) == s);
+	REQUIRE(a.bit_length() == s.size());
+	REQUIRE(a.covers(b));
+	REQUIRE(b.is_neighbor(basic_cube<2>::from_string("1" + std::string(70, '0') + "11")));
+	REQUIRE_THROWS_AS(cube::from_string(std::string(65, '1')), std::logic_error);
+}
+
+SCENARIO("QMS: more than 64 variables from set numbers", "[cube]") {
+	// 2^64 и 2^64 + 1 не помещаются в 64 бита: функция от 65 переменных, набор 2 - неопределенный
+	std::stringstream ss("18446744073709551616 18446744073709551617 d 2\n");
+	Quine_McCluskey_Simplifier QMS;
+	REQUIRE_NOTHROW(QMS.init(ss, true));
+	REQUIRE(QMS.variables() == 65);
+	REQUIRE_THROWS_AS(QMS.simplify(), std::logic_error);
+
+	simplify_options options;
+	options.engine = e_espresso;
+	simplify_stats stats;
+	options.stats = &stats;
+	QMS.simplify(options);
+	std::stringstream out, formula;
+	QMS.print_mdnf(out);
+	QMS.print_formula(formula);
+	REQUIRE(out.str() == "1" + std::string(63, '0') + "- ");
+	REQUIRE(formula.str().substr(0, 8) == "x0!x1!x2");
+	REQUIRE(QMS.mdnf().empty());
+	REQUIRE(QMS.wide_mdnf().size() == 1);
+	REQUIRE(stats.terms == 1);
+
+	// После функции от 64 переменных и меньше снова работает метод Квайна-МакКласки
+	std::stringstream narrow("1 3");
+	QMS.init(narrow, true);
+	QMS.simplify();
+	out.str("");
+	QMS.print_mdnf(out);
+	REQUIRE(out.str() == "-1 ");
+	REQUIRE(QMS.wide_mdnf().empty());
+
+	// 2^128 не помещается и в wide_cube
+	std::stringstream huge("1 340282366920938463463374607431768211456");
+	REQUIRE_THROWS_AS(QMS.init(huge, true), std::logic_error);
+}
+
+SCENARIO("cube_set: insert and contains", "[cube_set]") {
+	cube_set set;
+	for (std::uint64_t i = 0; i < 1000; ++i)
+		REQUIRE(set.insert(cube(i * 7)));
+
+	REQUIRE(set.size() == 1000);
+	REQUIRE_FALSE(set.insert(cube(7)));
+	REQUIRE(set.contains(cube(6993)));
+	REQUIRE_FALSE(set.contains(cube(6994)));
+	REQUIRE_FALSE(set.contains(cube::from_string("1-1")));
+}
+
+SCENARIO("QMS: repeated sets are loaded once", "[init(sets) -> sets]") {
+	Quine_McCluskey_Simplifier QMS;
+	std::stringstream in_ss("1 4 1 10 5 15 4 15"), out;
+	REQUIRE_NOTHROW(QMS.init(in_ss, true));
+	REQUIRE_NOTHROW(QMS.simplify());
+
+	QMS.print_mdnf(out);
+
+	REQUIRE(out.str() == (std::string)"0-01 010- 1010 1111 ");
+}
+
+SCENARIO("QMS: dense on-set", "[ts3]") {
+	Quine_McCluskey_Simplifier QMS;
+	std::stringstream in_vs("1111111011111111"), out;
+	REQUIRE_NOTHROW(QMS.init(in_vs, false));
+	REQUIRE_NOTHROW(QMS.simplify());
+
+	QMS.print_mdnf(out);
+
+	REQUIRE(out.str() == (std::string)"---0 --0- -0-- 1--- ");
+}
+
+SCENARIO("QMS: parallel combining gives the same result", "[threads]") {
+	std::string in_v(256, '0');
+	for (size_t i = 0, x = 1; i < in_v.size(); ++i) {
+		x = x * 1103515245 + 12345;
+		if ((x >> 16) % 3 == 0)
+			in_v[i] = '1';
+	}
+	std::stringstream in_serial(in_v), in_parallel(in_v), out_serial, out_parallel;
+	Quine_McCluskey_Simplifier serial, parallel;
+	serial.init(in_serial, false);
+	parallel.init(in_parallel, false);
+	parallel.set_threads(4);
+	REQUIRE_NOTHROW(serial.simplify());
+	REQUIRE_NOTHROW(parallel.simplify());
+
+	serial.print_mdnf(out_serial);
+	parallel.print_mdnf(out_parallel);
+
+	REQUIRE(out_serial.str() == out_parallel.str());
+}
+
+SCENARIO("cover_matrix: rows and columns", "[cover_matrix]") {
+	cover_matrix table(130, 70);
+	table.set(0, 0);
+	table.set(0, 69);
+	table.set(129, 69);
+	table.set(64, 3);
+
+	REQUIRE(table.get(0, 69));
+	REQUIRE_FALSE(table.get(1, 69));
+	REQUIRE(table.row_count(0) == 2);
+	REQUIRE(table.col_count(69) == 2);
+	REQUIRE(table.first_in_row(64) == 3);
+	REQUIRE(table.first_in_row(1) == table.cols());
+
+	std::vector<size_t> rows;
+	table.for_each_in_col(69, [&rows](size_t i) { rows.push_back(i); });
+	REQUIRE(rows == std::vector<size_t>({ 0, 129 }));
+}
+
+SCENARIO("QMS: greedy cover with updated counts", "[greedy]") {
+	// После каждого выбора счетчики непокрытых наборов уменьшаются, и покрытие
+	// то же, что при пересчете таблицы: при равенстве берется меньший номер
+	Quine_McCluskey_Simplifier QMS;
+	std::stringstream in_vs("1101101010110011"), out;
+	QMS.init(in_vs, false);
+	simplify_options options;
+	options.reduce = false;
+	REQUIRE_NOTHROW(QMS.simplify(options));
+
+	QMS.print_mdnf(out);
+
+	REQUIRE(out.str() == (std::string)"-000 00-1 000- 01-0 1-1- ");
+}
+
+SCENARIO("cover_solver: greedy cover with updated counts", "[greedy]") {
+	// Столбцы 0 и 1 покрывают по 4 строки, берется меньший номер. После этого
+	// у столбца 1 остается 2 непокрытые строки, и следующим берется столбец 2 (3 строки)
+	cover_matrix table(7, 4);
+	for (size_t i = 0; i < 4; ++i)
+		table.set(i, 0);
+	for (size_t i = 2; i < 6; ++i)
+		table.set(i, 1);
+	for (size_t i = 4; i < 7; ++i)
+		table.set(i, 2);
+	table.set(6, 3);
+	cover_solver solver(table);
+
+	REQUIRE(solver.greedy() == std::vector<size_t>({ 0, 2 }));
+}
+
+SCENARIO("QMS: exact cover is smaller than greedy", "[exact]") {
+	std::string in_v("1101101010110011");
+	std::stringstream in_greedy(in_v), in_exact(in_v), out_greedy, out_exact;
+	Quine_McCluskey_Simplifier greedy, exact;
+	greedy.init(in_greedy, false);
+	exact.init(in_exact, false);
+	simplify_options options;
+	options.reduce = false;
+	REQUIRE_NOTHROW(greedy.simplify(options));
+	options.cover = c_exact;
+	REQUIRE_NOTHROW(exact.simplify(options));
+
+	greedy.print_mdnf(out_greedy);
+	exact.print_mdnf(out_exact);
+
+	REQUIRE(out_greedy.str() == (std::string)"-000 00-1 000- 01-0 1-1- ");
+	REQUIRE(out_exact.str() == (std::string)"-000 00-1 01-0 1-1- ");
+	REQUIRE_FALSE(greedy.is_minimal());
+	REQUIRE(exact.is_minimal());
+}
+
+SCENARIO("QMS: exact cover falls back to greedy when out of budget", "[exact]") {
+	Quine_McCluskey_Simplifier QMS;
+	std::stringstream in_vs("1101101010110011"), out;
+	QMS.init(in_vs, false);
+	simplify_options options;
+	options.cover = c_exact;
+	options.reduce = false;
+	options.node_limit = 0;
+	REQUIRE_NOTHROW(QMS.simplify(options));
+
+	QMS.print_mdnf(out);
+
+	REQUIRE(out.str() == (std::string)"-000 00-1 000- 01-0 1-1- ");
+	REQUIRE_FALSE(QMS.is_minimal());
+}
+
+SCENARIO("cover_solver: exact cover of a cycle", "[exact]") {
+	// Столбец j покрывает строки j и j + 1 (по модулю 9): существенных и доминируемых нет
+	// ни в корне, ни после первого выбора, минимальное покрытие - 5 столбцов
+	cover_matrix table(9, 9);
+	for (size_t j = 0; j < 9; ++j) {
+		table.set(j, j);
+		table.set((j + 1) % 9, j);
+	}
+	cover_solver solver(table);
+	const auto cover = solver.exact(1000, std::chrono::milliseconds(1000));
+
+	REQUIRE(cover.size() == 5);
+	REQUIRE(solver.optimal());
+	std::vector<char> covered(9, 0);
+	for (const auto j : cover)
+		covered[j] = covered[(j + 1) % 9] = 1;
+	REQUIRE(std::count(covered.begin(), covered.end(), 1) == 9);
+}
+
+SCENARIO("QMS: table reduction before greedy cover", "[reduce]") {
+	Quine_McCluskey_Simplifier QMS;
+	std::stringstream in_vs("1101101010110011"), out;
+	QMS.init(in_vs, false);
+	REQUIRE_NOTHROW(QMS.simplify());
+
+	QMS.print_mdnf(out);
+
+	REQUIRE(out.str() == (std::string)"-000 00-1 01-0 1-1- ");
+}
+
+SCENARIO("cover_solver: reduction to the cyclic core", "[reduce]") {
+	// Строка 0 покрыта только столбцом 0; после его выбора столбцы 2, 3 и 4
+	// доминируются столбцом 1, который становится существенным
+	cover_matrix table(4, 5);
+	table.set(0, 0);
+	table.set(1, 0);
+	table.set(1, 1);
+	table.set(2, 1);
+	table.set(2, 2);
+	table.set(2, 3);
+	table.set(3, 2);
+	table.set(3, 4);
+	table.set(3, 1);
+	cover_solver solver(table);
+
+	REQUIRE(solver.reduce() == std::vector<size_t>({ 0, 1 }));
+	REQUIRE(solver.rows_left() == 0);
+
+	cover_matrix cyclic(3, 3);
+	cyclic.set(0, 0);
+	cyclic.set(0, 1);
+	cyclic.set(1, 1);
+	cyclic.set(1, 2);
+	cyclic.set(2, 2);
+	cyclic.set(2, 0);
+	cover_solver core(cyclic);
+
+	REQUIRE(core.reduce().empty());
+	REQUIRE(core.rows_left() == 3);
+	REQUIRE(core.cols_left() == 3);
+	REQUIRE(core.exact(100, std::chrono::milliseconds(1000)).size() == 2);
+	REQUIRE(core.optimal());
+}
+
+SCENARIO("QMS: don't care sets", "[dont_cares]") {
+	Quine_McCluskey_Simplifier QMS;
+	std::stringstream in_ss("1 3 7 11 15 d 0 2 5"), out;
+	REQUIRE_NOTHROW(QMS.init(in_ss, true));
+	REQUIRE_NOTHROW(QMS.simplify());
+
+	QMS.print_mdnf(out);
+
+	REQUIRE(out.str() == (std::string)"--11 00-- ");
+}
+
+SCENARIO("QMS: don't care values in vector", "[dont_cares]") {
+	Quine_McCluskey_Simplifier QMS;
+	std::stringstream in_vs("-1-1-1-1-1-1-1-0"), out;
+	REQUIRE_NOTHROW(QMS.init(in_vs, false));
+	REQUIRE_NOTHROW(QMS.simplify());
+
+	QMS.print_mdnf(out);
+
+	REQUIRE(out.str() == (std::string)"--0- -0-- 0--- ");
+}
+
+SCENARIO("log_expr: vector of a formula with many variables", "[log_expr]") {
+	log_expr le("x1 & !x2 + x3 & (x4 + !x5) + x6 & x7 & x8");
+	std::stringstream out;
+	le.print(out);
+	const auto v = out.str();
+
+	REQUIRE(v.size() == 256);
+	size_t wrong = 0;
+	for (size_t p = 0; p < v.size(); ++p) {
+		auto x = [p](size_t k) { return ((p >> k) & 1) != 0; };
+		const auto f = (x(0) && !x(1)) || (x(2) && (x(3) || !x(4))) || (x(5) && x(6) && x(7));
+		if (v[p] != (f ? '1' : '0'))
+			++wrong;
+	}
+	REQUIRE(wrong == 0);
+}
+
+SCENARIO("log_expr: too many variables for a vector", "[log_expr]") {
+	std::string str = "x1";
+	for (size_t i = 2; i <= 64; ++i)
+		str += "+x" + std::to_string(i);
+	log_expr le(str);
+	std::stringstream out;
+
+	REQUIRE_THROWS_AS(le.print(out), std::runtime_error);
+	REQUIRE_THROWS_AS(le.minterms(), std::runtime_error);
+}
+
+SCENARIO("QMS: init with formula minterms, out sets", "[init(minterms) -> sets]") {
+	Quine_McCluskey_Simplifier QMS;
+	log_expr le("(x1   + x3) &	(x2&x4)");
+	std::stringstream out;
+
+	REQUIRE(le.minterms() == std::vector<std::uint64_t>({ 13, 14, 15 }));
+	REQUIRE_NOTHROW(QMS.init(le.minterms()));
+	REQUIRE_NOTHROW(QMS.simplify());
+
+	QMS.print_mdnf(out);
+
+	REQUIRE(out.str() == (std::string)"11-1 111- ");
+}
+
+SCENARIO("vector_scan: blocks and tail", "[vector_scan]") {
+	std::string v(100, '0');
+	v[0] = v[15] = v[16] = v[63] = v[99] = '1';
+	v[31] = v[64] = '-';
+	std::vector<std::uint64_t> ones, dont_cares, ones_s, dont_cares_s;
+
+	REQUIRE(vector_scan::scan(v.data(), v.size(), 8, ones, dont_cares));
+	REQUIRE(vector_scan::scan_scalar(v.data(), v.size(), 8, ones_s, dont_cares_s));
+	REQUIRE(ones == std::vector<std::uint64_t>({ 8, 23, 24, 71, 107 }));
+	REQUIRE(dont_cares == std::vector<std::uint64_t>({ 39, 72 }));
+	REQUIRE(ones == ones_s);
+	REQUIRE(dont_cares == dont_cares_s);
+
+	v[40] = '2';
+	REQUIRE_FALSE(vector_scan::scan(v.data(), v.size(), 0, ones, dont_cares));
+	v[40] = '0';
+	v[98] = 'x';
+	REQUIRE_FALSE(vector_scan::scan(v.data(), v.size(), 0, ones, dont_cares));
+}
+
+SCENARIO("QMS: init with mapped files", "[init(file)]") {
+	std::string in_v("0111-0000110--00");
+	std::ofstream("in_v.txt") << in_v;
+	std::ofstream("in_bad_v.txt") << "0111-0000110--0";
+	Quine_McCluskey_Simplifier from_file, from_stream;
+	std::stringstream in_ss(in_v), out_file, out_stream;
+
+	REQUIRE_NOTHROW(from_file.init(std::string("in_v.txt"), false));
+	from_stream.init(in_ss, false);
+	from_file.simplify();
+	from_stream.simplify();
+	from_file.print_mdnf(out_file);
+	from_stream.print_mdnf(out_stream);
+	REQUIRE(out_file.str() == out_stream.str());
+
+	std::stringstream out_sets;
+	REQUIRE_NOTHROW(from_file.init(std::string("in_s.txt"), true));
+	from_file.simplify();
+	from_file.print_mdnf(out_sets);
+	REQUIRE(out_sets.str().size() != 0);
+
+	REQUIRE_THROWS_AS(from_file.init(std::string("in_bad_v.txt"), false), std::logic_error);
+	REQUIRE_THROWS_AS(from_file.init(std::string("not_ext_file.txt"), true), std::logic_error);
+	std::remove("in_v.txt");
+	std::remove("in_bad_v.txt");
+}
+
+SCENARIO("set_tokenizer: numbers, separators and don't cares", "[set_tokenizer]") {
+	std::string in_s("1,4  10;18446744073709551615 d 2\n3 abd 7\n8");
+	set_tokenizer tokens(in_s.data(), in_s.data() + in_s.size());
+	std::vector<std::uint64_t> ones, dont_cares;
+	std::uint64_t set;
+	while (tokens.next(set))
+		(tokens.dont_care() ? dont_cares : ones).push_back(set);
+
+	REQUIRE(ones == std::vector<std::uint64_t>({ 1, 4, 10, 18446744073709551615ULL, 3, 8 }));
+	REQUIRE(dont_cares == std::vector<std::uint64_t>({ 2, 7 }));
+
+	std::string too_long("1 18446744073709551616");
+	set_tokenizer overflow(too_long.data(), too_long.data() + too_long.size());
+	REQUIRE(overflow.next(set));
+	REQUIRE_THROWS_AS(overflow.next(set), std::logic_error);
+}
+
+SCENARIO("set_tokenizer: numbers of several words", "[set_tokenizer]") {
+	const std::string text = "340282366920938463463374607431768211455 d 18446744073709551616";
+	set_tokenizer tokens(text.data(), text.data() + text.size());
+	std::uint64_t words[2];
+	REQUIRE(tokens.next(words, 2));
+	REQUIRE(words[0] == UINT64_MAX);
+	REQUIRE(words[1] == UINT64_MAX);
+	REQUIRE(!tokens.dont_care());
+	REQUIRE(tokens.next(words, 2));
+	REQUIRE(words[0] == 0);
+	REQUIRE(words[1] == 1);
+	REQUIRE(tokens.dont_care());
+	REQUIRE(!tokens.next(words, 2));
+}
+
+SCENARIO("QMS: number of variables from the largest set", "[init(sets) -> sets]") {
+	Quine_McCluskey_Simplifier QMS;
+	std::stringstream in_ss("0 1 2 3 d 8"), out;
+	REQUIRE_NOTHROW(QMS.init(in_ss, true));
+	QMS.simplify();
+	QMS.print_mdnf(out);
+
+	REQUIRE(out.str() == "00-- ");
+}
+
+SCENARIO("QMS: number of variables given explicitly", "[init(minterms) -> sets]") {
+	// Наборы 0 и 1 от трех переменных: старшие переменные везде равны нулю, но не теряются
+	Quine_McCluskey_Simplifier QMS;
+	std::stringstream out;
+	QMS.init(std::vector<std::uint64_t>({ 0, 1 }), std::vector<std::uint64_t>(), 3);
+	QMS.simplify();
+	QMS.print_mdnf(out);
+
+	REQUIRE(out.str() == "00- ");
+	REQUIRE_THROWS_AS(QMS.init(std::vector<std::uint64_t>({ 0 }), std::vector<std::uint64_t>(), 65), std::logic_error);
+}
+
+SCENARIO("batch_simplifier: results in input order", "[batch]") {
+	std::vector<boolean_function> functions;
+	std::uint64_t seed = 17;
+	for (size_t f = 0; f < 40; ++f) {
+		boolean_function fn;
+		for (std::uint64_t i = 0; i < 32; ++i) {
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			const auto r = (seed >> 33) % 4;
+			if (r == 0)
+				fn.ones.push_back(i);
+			else if (r == 1 && f % 2 == 0)
+				fn.dont_cares.push_back(i);
+		}
+		functions.push_back(fn);
+	}
+	batch_simplifier serial(1), parallel(4);
+	const auto expected = serial.simplify(functions);
+	const auto got = parallel.simplify(functions);
+	const auto again = parallel.simplify(functions);
+
+	REQUIRE(parallel.threads() == 4);
+	REQUIRE(got.size() == functions.size());
+	for (size_t f = 0; f < functions.size(); ++f) {
+		Quine_McCluskey_Simplifier QMS;
+		QMS.init(functions[f].ones, functions[f].dont_cares);
+		QMS.simplify();
+		const std::vector<cube> single(QMS.mdnf().begin(), QMS.mdnf().end());
+		REQUIRE(expected[f].mdnf == single);
+		REQUIRE(got[f].mdnf == single);
+		REQUIRE(again[f].mdnf == single);
+		REQUIRE(got[f].vars == QMS.variables());
+	}
+}
+
+SCENARIO("QMS: simplify can be called again after init", "[reuse]") {
+	Quine_McCluskey_Simplifier QMS;
+	std::stringstream first("1 4 10 5 15"), second("2"), out_first, out_second;
+	QMS.init(first, true);
+	QMS.simplify();
+	QMS.simplify();
+	QMS.print_mdnf(out_first);
+	QMS.init(second, true);
+	QMS.simplify();
+	QMS.print_mdnf(out_second);
+
+	REQUIRE(out_first.str() == "0-01 010- 1010 1111 ");
+	REQUIRE(out_second.str() == "10 ");
+}
+
+SCENARIO("multi_output_simplifier: shared terms", "[multi_output]") {
+	std::vector<boolean_function> outputs(2);
+	outputs[0].ones = { 3, 6, 7 };
+	outputs[1].ones = { 1, 3, 7 };
+	multi_output_simplifier PLA;
+	PLA.init(outputs);
+	PLA.simplify();
+	std::stringstream out;
+	PLA.print_mdnf(out);
+
+	REQUIRE(PLA.variables() == 3);
+	REQUIRE(out.str() == "-11 11\n0-1 01\n11- 10\n");
+	REQUIRE(PLA.mdnf(0) == std::vector<cube>({ cube::from_string("-11"), cube::from_string("11-") }));
+}
+
+SCENARIO("multi_output_simplifier: options", "[multi_output]") {
+	std::vector<boolean_function> outputs(2);
+	outputs[0].ones = { 1, 3, 5, 7 };
+	outputs[1].ones = { 3, 7, 6 };
+	multi_output_simplifier PLA;
+	PLA.init(outputs);
+	simplify_options options;
+	options.engine = e_espresso;
+	REQUIRE_THROWS_AS(PLA.simplify(options), std::logic_error);
+	options.engine = e_implicit;
+	REQUIRE_THROWS_AS(PLA.simplify(options), std::logic_error);
+
+	options.engine = e_quine_mccluskey;
+	simplify_stats stats;
+	options.stats = &stats;
+	PLA.simplify(options);
+	REQUIRE(stats.primes > 0);
+	REQUIRE(stats.table_rows == 7);
+	REQUIRE(stats.table_cols == stats.primes);
+	REQUIRE(stats.terms == PLA.terms().size());
+	REQUIRE(stats.reduce_picks + stats.cover_picks == stats.terms);
+}
+
+SCENARIO("multi_output_simplifier: covers every output with fewer terms", "[multi_output]") {
+	std::uint64_t seed = 5;
+	for (size_t round = 0; round < 30; ++round) {
+		std::vector<boolean_function> outputs(3);
+		for (auto& f : outputs) {
+			for (std::uint64_t x = 0; x < 16; ++x) {
+				seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+				const auto r = (seed >> 33) % 5;
+				if (r < 2)
+					f.ones.push_back(x);
+				else if (r == 2)
+					f.dont_cares.push_back(x);
+			}
+			f.ones.push_back(15);
+		}
+		simplify_options options;
+		options.cover = c_exact;
+		multi_output_simplifier PLA;
+		PLA.init(outputs);
+		PLA.simplify(options);
+		REQUIRE(PLA.is_minimal());
+
+		cube_set separate;
+		size_t distinct = 0;
+		for (size_t i = 0; i < outputs.size(); ++i) {
+			const auto terms = PLA.mdnf(i);
+			for (std::uint64_t x = 0; x < 16; ++x) {
+				const auto on = std::find(outputs[i].ones.begin(), outputs[i].ones.end(), x) != outputs[i].ones.end();
+				const auto dc = std::find(outputs[i].dont_cares.begin(), outputs[i].dont_cares.end(), x) != outputs[i].dont_cares.end();
+				const auto covered = std::any_of(terms.begin(), terms.end(), [x](const cube& c) { return c.covers(cube(x)); });
+				if (on)
+					REQUIRE(covered);
+				else if (!dc)
+					REQUIRE_FALSE(covered);
+			}
+			Quine_McCluskey_Simplifier QMS;
+			QMS.init(outputs[i].ones, outputs[i].dont_cares);
+			QMS.simplify(options);
+			for (const auto& c : QMS.mdnf())
+				if (separate.insert(c))
+					++distinct;
+		}
+		REQUIRE(PLA.terms().size() <= distinct);
+	}
+}
+
+SCENARIO("QMS: espresso engine gives a valid cover", "[espresso]") {
+	std::uint64_t seed = 11;
+	for (size_t round = 0; round < 40; ++round) {
+		std::vector<std::uint64_t> ones, dont_cares;
+		for (std::uint64_t x = 0; x < 64; ++x) {
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			const auto r = (seed >> 33) % 5;
+			if (r < 2)
+				ones.push_back(x);
+			else if (r == 2)
+				dont_cares.push_back(x);
+		}
+		ones.push_back(63);
+		simplify_options options;
+		options.engine = e_espresso;
+		Quine_McCluskey_Simplifier heuristic, exact;
+		heuristic.init(ones, dont_cares);
+		heuristic.simplify(options);
+		exact.init(ones, dont_cares);
+		exact.simplify();
+
+		const auto& terms = heuristic.mdnf();
+		for (std::uint64_t x = 0; x < 64; ++x) {
+			const auto on = std::find(ones.begin(), ones.end(), x) != ones.end();
+			const auto dc = std::find(dont_cares.begin(), dont_cares.end(), x) != dont_cares.end();
+			const auto covered = std::any_of(terms.begin(), terms.end(), [x](const cube& c) { return c.covers(cube(x)); });
+			if (on)
+				REQUIRE(covered);
+			else if (!dc)
+				REQUIRE_FALSE(covered);
+		}
+		REQUIRE(terms.size() <= exact.mdnf().size() + 2);
+		REQUIRE_FALSE(heuristic.is_minimal());
+	}
+}
+
+SCENARIO("QMS: espresso engine with 40 variables", "[espresso]") {
+	std::vector<std::uint64_t> ones;
+	const auto high = std::uint64_t(1) << 39;
+	for (std::uint64_t i = 0; i < 1024; ++i) {
+		ones.push_back(high | (i << 20));
+		ones.push_back(high | (std::uint64_t(1) << 38) | i);
+	}
+	simplify_options options;
+	options.engine = e_espresso;
+	Quine_McCluskey_Simplifier QMS;
+	QMS.init(ones);
+	QMS.simplify(options);
+	std::stringstream out;
+	QMS.print_mdnf(out);
+
+	REQUIRE(QMS.variables() == 40);
+	REQUIRE(out.str() == "1000000000----------00000000000000000000 110000000000000000000000000000---------- ");
+}
+
+SCENARIO("wide_espresso: 100 variables across two words", "[espresso]") {
+	// Те же две группы, что и для 40 переменных, но импликанты переходят границу слов
+	std::vector<wide_cube> ones;
+	const std::uint64_t none[2] = { 0, 0 };
+	for (std::uint64_t i = 0; i < 1024; ++i) {
+		const std::uint64_t a[2] = { i << 60, (std::uint64_t(1) << 35) | (i >> 4) };
+		const std::uint64_t b[2] = { i, (std::uint64_t(1) << 35) | (std::uint64_t(1) << 34) };
+		ones.push_back(wide_cube::from_words(a, none));
+		ones.push_back(wide_cube::from_words(b, none));
+	}
+	const wide_espresso engine(100, std::vector<wide_cube>());
+	const auto res = engine.minimize(ones);
+
+	REQUIRE(res.size() == 2);
+	REQUIRE(res[0].to_string(100) == "1" + std::string(29, '0') + std::string(10, '-') + std::string(60, '0'));
+	REQUIRE(res[1].to_string(100) == "11" + std::string(88, '0') + std::string(10, '-'));
+	REQUIRE_THROWS_AS(wide_espresso(129, std::vector<wide_cube>()), std::logic_error);
+}
+
+SCENARIO("log_expr: deeply nested formula", "[log_expr]") {
+	std::string in_f;
+	for (size_t i = 0; i < 100000; ++i)
+		in_f += "x1&(";
+	in_f += "x1+x2";
+	in_f += std::string(100000, ')');
+	std::stringstream out;
+	REQUIRE_NOTHROW(log_expr(in_f));
+
+	log_expr le(in_f);
+	le.print(out);
+	REQUIRE(out.str() == "0101");
+}
+
+SCENARIO("QMS: statistics of simplify", "[stats]") {
+	Quine_McCluskey_Simplifier QMS;
+	QMS.init({ 0, 1, 2, 5, 6, 7 });
+	simplify_stats stats;
+	simplify_options options;
+	options.cover = c_exact;
+	options.stats = &stats;
+	QMS.simplify(options);
+
+	REQUIRE(stats.rounds == stats.cubes_per_round.size());
+	REQUIRE(stats.rounds >= 2);
+	REQUIRE(stats.cubes_per_round[0] == 6);
+	REQUIRE(stats.comparisons > 0);
+	REQUIRE(stats.primes == 6);
+	REQUIRE(stats.essential == 0);
+	REQUIRE(stats.table_rows == 6);
+	REQUIRE(stats.table_cols == 6);
+	REQUIRE(stats.terms == QMS.mdnf().size());
+	REQUIRE(stats.essential + stats.reduce_picks + stats.cover_picks == stats.terms);
+	REQUIRE(stats.total_ms >= stats.implicants_ms);
+
+	std::stringstream out;
+	stats.print(out);
+	REQUIRE(out.str().find("primes: 6\n") != std::string::npos);
+}
+
+SCENARIO("bdd: on-set and prime cover of a formula", "[bdd]") {
+	const std::vector<std::string> formulas = {
+		"a1&!a2+a3&(a4+!a1)",
+		"!(a1+a2)&a3+a4&a5+a2&!a5",
+		"a1&a2&!a3+a4&!a5"
+	};
+	for (const auto& str : formulas) {
+		log_expr le(str);
+		bdd manager(le.variables());
+		const auto f = le.to_bdd(manager);
+		const auto ones = manager.minterms(f);
+		REQUIRE(ones == le.minterms());
+
+		const auto cover = manager.prime_cover(f);
+		const auto all = (std::uint64_t(1) << le.variables()) - 1;
+		auto inside = [&ones, all](const cube& c) {
+			for (std::uint64_t x = 0; x <= all; ++x)
+				if (c.covers(cube(x)) && !std::binary_search(ones.begin(), ones.end(), x))
+					return false;
+			return true;
+		};
+		for (const auto x : ones) {
+			size_t k = 0;
+			for (const auto& c : cover)
+				if (c.covers(cube(x)))
+					++k;
+			REQUIRE(k > 0);
+		}
+		for (const auto& c : cover) {
+			REQUIRE(inside(c));
+			// Простой: ни одну переменную убрать нельзя
+			for (auto fixed = ~c.mask(0) & all; fixed != 0; fixed &= fixed - 1) {
+				const auto bit = fixed & (~fixed + 1);
+				REQUIRE_FALSE(inside(cube(c.value(0) & ~bit, c.mask(0) | bit)));
+			}
+		}
+
+		Quine_McCluskey_Simplifier QMS;
+		QMS.init(ones);
+		simplify_options options;
+		options.cover = c_exact;
+		QMS.simplify(options);
+		REQUIRE(cover.size() >= QMS.mdnf().size());
+	}
+}
+
+SCENARIO("bdd: formula with 40 variables", "[bdd]") {
+	std::string str;
+	for (size_t i = 0; i < 20; ++i) {
+		if (i)
+			str += "+";
+		str += "x" + std::to_string(2 * i + 1) + "&x" + std::to_string(2 * i + 2);
+	}
+	log_expr le(str);
+	REQUIRE(le.variables() == 40);
+	bdd manager(le.variables());
+	const auto f = le.to_bdd(manager);
+	REQUIRE(manager.size() < 200);
+
+	const auto cover = manager.prime_cover(f);
+	REQUIRE(cover.size() == 20);
+	for (const auto& c : cover)
+		REQUIRE(bits::popcount(~c.mask(0) & ((std::uint64_t(1) << 40) - 1)) == 2);
+	REQUIRE(cover.front().to_string(40) == std::string(38, '-') + "11");
+}
+
+SCENARIO("bdd: union of cubes with many don't cares", "[bdd]") {
+	// 32 куба по 62 '-': при разбиении с копированием кубов в обе ветви их было бы 2^62
+	std::string str;
+	std::vector<cube> cubes;
+	for (size_t i = 0; i < 32; ++i) {
+		if (i)
+			str += "+";
+		str += "x" + std::to_string(2 * i + 1) + "&x" + std::to_string(2 * i + 2);
+		const auto pair = std::uint64_t(3) << (2 * i);
+		cubes.push_back(cube(pair, ~pair));
+	}
+	log_expr le(str);
+	bdd manager(le.variables());
+	const auto f = le.to_bdd(manager);
+	REQUIRE(manager.from_cubes(cubes) == f);
+	REQUIRE(manager.from_cubes(std::vector<cube>()) == bdd::zero);
+}
+
+SCENARIO("bdd: garbage collection keeps the given functions", "[bdd]") {
+	log_expr le("x1&x2+x3&!x4+x5");
+	bdd manager(le.variables());
+	std::vector<size_t> roots(1, le.to_bdd(manager));
+	const auto count = manager.count(roots[0]);
+	manager.conj(manager.variable(0), manager.negate(manager.variable(4)));
+	const auto before = manager.size();
+	manager.collect(roots);
+	REQUIRE(manager.size() < before);
+	REQUIRE(manager.count(roots[0]) == count);
+	for (std::uint64_t x = 0; x < 32; ++x)
+		REQUIRE(manager.value(roots[0], x) == (((x & 3) == 3) || ((x & 12) == 4) || (x & 16)));
+	// Таблица уникальности перестроена: та же функция получает тот же номер
+	REQUIRE(le.to_bdd(manager) == roots[0]);
+}
+
+SCENARIO("zdd: primes of a function", "[zdd]") {
+	// x0 x1 + !x0 x2: простые импликанты x0 x1, !x0 x2 и x1 x2
+	bdd manager(3);
+	const auto x0 = manager.variable(0), x1 = manager.variable(1), x2 = manager.variable(2);
+	const auto f = manager.disj(manager.conj(x0, x1), manager.conj(manager.negate(x0), x2));
+	zdd family;
+	const auto p = family.primes(manager, f);
+	REQUIRE(family.count(p) == 3);
+	const auto primes = family.cubes(p, 3);
+	REQUIRE(primes.size() == 3);
+	REQUIRE(std::find(primes.begin(), primes.end(), cube(3, 4)) != primes.end());
+	REQUIRE(std::find(primes.begin(), primes.end(), cube(4, 2)) != primes.end());
+	REQUIRE(std::find(primes.begin(), primes.end(), cube(6, 1)) != primes.end());
+	REQUIRE(family.count(family.primes(manager, bdd::one)) == 1);
+	REQUIRE(family.count(family.primes(manager, bdd::zero)) == 0);
+}
+
+SCENARIO("QMS: implicit prime generation", "[zdd]") {
+	std::mt19937_64 rng(7);
+	for (size_t t = 0; t < 20; ++t) {
+		std::vector<std::uint64_t> ones, dont_cares;
+		for (std::uint64_t x = 0; x < 64; ++x) {
+			const auto r = rng() % 8;
+			if (r < 3)
+				ones.push_back(x);
+			else if (r == 3)
+				dont_cares.push_back(x);
+		}
+		ones.push_back(63);
+		dont_cares.erase(std::remove(dont_cares.begin(), dont_cares.end(), 63), dont_cares.end());
+		simplify_stats explicit_stats, implicit_stats;
+		simplify_options options;
+		options.cover = c_exact;
+		options.stats = &explicit_stats;
+		Quine_McCluskey_Simplifier QMS;
+		QMS.init(ones, dont_cares);
+		QMS.simplify(options);
+		const auto terms = QMS.mdnf().size();
+
+		options.engine = e_implicit;
+		options.stats = &implicit_stats;
+		QMS.simplify(options);
+		REQUIRE(implicit_stats.primes == explicit_stats.primes);
+		REQUIRE(implicit_stats.essential == explicit_stats.essential);
+		REQUIRE(QMS.mdnf().size() == terms);
+		for (const auto x : ones) {
+			auto covered = false;
+			for (const auto& c : QMS.mdnf())
+				covered = covered || c.covers(cube(x));
+			REQUIRE(covered);
+		}
+		// В таблицу покрытия попадают только импликанты циклической части
+		REQUIRE(implicit_stats.table_rows == explicit_stats.table_rows);
+		REQUIRE(implicit_stats.table_cols <= explicit_stats.table_cols);
+		REQUIRE(implicit_stats.rounds == 0);
+	}
+}
+
+SCENARIO("QMS: implicit prime generation with a cyclic core", "[zdd]") {
+	// Все наборы, кроме 000 и 111: 6 простых импликант, ни одного существенного
+	Quine_McCluskey_Simplifier QMS;
+	QMS.init(std::vector<std::uint64_t>({ 1, 2, 3, 4, 5, 6 }));
+	simplify_stats stats;
+	simplify_options options;
+	options.engine = e_implicit;
+	options.cover = c_exact;
+	options.stats = &stats;
+	QMS.simplify(options);
+	REQUIRE(stats.primes == 6);
+	REQUIRE(stats.essential == 0);
+	REQUIRE(stats.table_rows == 6);
+	REQUIRE(stats.table_cols == 6);
+	REQUIRE(QMS.mdnf().size() == 3);
+	REQUIRE(QMS.is_minimal());
+
+	options.prime_limit = 5;
+	REQUIRE_THROWS_AS(QMS.simplify(options), std::logic_error);
+
+	// Все импликанты существенные: таблица покрытия пустая при любом ограничении
+	QMS.init(std::vector<std::uint64_t>({ 0, 1, 6, 7 }));
+	options.prime_limit = 0;
+	QMS.simplify(options);
+	REQUIRE(stats.primes == 2);
+	REQUIRE(stats.essential == 2);
+	REQUIRE(stats.table_cols == 0);
+}
+
+SCENARIO("result_cache: results survive a restart", "[cache]") {
+	std::remove("qms_cache.txt");
+	simplify_options options;
+	std::string expected;
+	{
+		result_cache cache("qms_cache.txt");
+		options.cache = &cache;
+		Quine_McCluskey_Simplifier QMS;
+		QMS.init(std::vector<std::uint64_t>({ 1, 4, 10, 5, 15 }), std::vector<std::uint64_t>({ 0 }));
+		QMS.simplify(options);
+		std::stringstream out;
+		QMS.print_mdnf(out);
+		expected = out.str();
+		REQUIRE(cache.size() == 1);
+	}
+
+	result_cache cache("qms_cache.txt");
+	REQUIRE(cache.size() == 1);
+	options.cache = &cache;
+	simplify_stats stats;
+	options.stats = &stats;
+	Quine_McCluskey_Simplifier QMS;
+	// Порядок наборов на ключ не влияет
+	QMS.init(std::vector<std::uint64_t>({ 15, 10, 5, 4, 1 }), std::vector<std::uint64_t>({ 0 }));
+	QMS.simplify(options);
+	std::stringstream out;
+	QMS.print_mdnf(out);
+	REQUIRE(out.str() == expected);
+	REQUIRE(stats.primes == 0);
+	REQUIRE(stats.terms == QMS.mdnf().size());
+	REQUIRE(cache.size() == 1);
+
+	// Другие параметры - другой ключ
+	options.cover = c_exact;
+	QMS.simplify(options);
+	REQUIRE(cache.size() == 2);
+	REQUIRE(stats.primes > 0);
+	// Другие неопределенные наборы - другой ключ
+	QMS.init(std::vector<std::uint64_t>({ 15, 10, 5, 4, 1 }));
+	QMS.simplify(options);
+	REQUIRE(cache.size() == 3);
+	std::remove("qms_cache.txt");
+}
+
+SCENARIO("result_cache: damaged and unproven entries are not used", "[cache]") {
+	std::remove("qms_cache.txt");
+	simplify_options options;
+	{
+		result_cache cache("qms_cache.txt");
+		options.cache = &cache;
+		Quine_McCluskey_Simplifier QMS;
+		QMS.init(std::vector<std::uint64_t>({ 1, 4, 10, 5, 15 }));
+		QMS.simplify(options);
+		QMS.init(std::vector<std::uint64_t>({ 1, 4, 10, 5 }));
+		QMS.simplify(options);
+		REQUIRE(cache.size() == 2);
+
+		// Тот же первый хэш с другим вторым - промах
+		const auto key = result_cache::key(std::vector<cube>({ cube(3, 0) }), std::vector<cube>(), 2, options);
+		cache.insert(key, { 2, std::vector<cube>({ cube(3, 0) }), true });
+		simplify_result res;
+		REQUIRE(cache.find(key, res));
+		REQUIRE_FALSE(cache.find({ key.hash, key.check ^ 1 }, res));
+		REQUIRE(cache.size() == 3);
+
+		// Точный выбор, не успевший доказать минимальность, не запоминается
+		std::stringstream in_vs("1101101010110011");
+		QMS.init(in_vs, false);
+		options.cover = c_exact;
+		options.reduce = false;
+		options.node_limit = 0;
+		QMS.simplify(options);
+		REQUIRE_FALSE(QMS.is_minimal());
+		REQUIRE(cache.size() == 3);
+	}
+
+	// Последняя запись обрезана (как при сбое во время записи)
+	std::string text;
+	{
+		std::ifstream in("qms_cache.txt");
+		std::stringstream ss;
+		ss << in.rdbuf();
+		text = ss.str();
+	}
+	REQUIRE(text.size() > 3);
+	{
+		std::ofstream out("qms_cache.txt", std::ios::trunc);
+		out << text.substr(0, text.size() - 3);
+	}
+	REQUIRE(result_cache("qms_cache.txt").size() == 2);
+	// Строка без контрольной суммы (старый формат) не читается
+	{
+		std::ofstream out("qms_cache.txt", std::ios::trunc);
+		out << "1 2 1 1 0:3\n";
+	}
+	REQUIRE(result_cache("qms_cache.txt").size() == 0);
+	std::remove("qms_cache.txt");
+}
+
+SCENARIO("bdd: large formula minimized from its prime cover", "[bdd]") {
+	std::string str;
+	for (size_t i = 0; i < 20; ++i) {
+		if (i)
+			str += "+";
+		str += "x" + std::to_string(2 * i + 1) + "&x" + std::to_string(2 * i + 2);
+	}
+	log_expr le(str);
+	bdd manager(le.variables());
+	const auto f = le.to_bdd(manager);
+	// Нулей 3^20: в каждой из 20 пар не обе переменные равны 1
+	REQUIRE(manager.count(f) == std::ldexp(1, 40) - std::pow(3.0, 20));
+	REQUIRE(manager.count(manager.variable(3)) == std::ldexp(1, 39));
+
+	Quine_McCluskey_Simplifier QMS;
+	QMS.init_cubes(manager.prime_cover(f), le.variables());
+	REQUIRE_THROWS_AS(QMS.simplify(), std::logic_error);
+	simplify_options options;
+	options.engine = e_espresso;
+	QMS.simplify(options);
+	REQUIRE(QMS.variables() == 40);
+	REQUIRE(QMS.mdnf().size() == 20);
+}
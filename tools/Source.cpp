@@ -1,25 +1,45 @@
 #include <iostream>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <sstream>
 #include <vector>
 #include "Quine_McCluskey_Simplifier.hpp"
 #include "log_expr.hpp"
+#include "result_cache.hpp"
 
 int main(int argc, char* argv[]) {
 	if (argc == 2) {
 		if (std::string(argv[1]) == "-h" || std::string(argv[1]) == "-help") {
-			std::cout << "usage: qms -input_mode -output_mode input_file output_file. \n\
+			std::cout << "usage: qms -input_mode -output_mode input_file output_file [-stats] [-cache cache_file]. \n\
 input_mode can take one of the following values: \n \
 -f\t if the function in the file is represented by the formula\n \
+\t (formulas with more than 2^20 true sets are not expanded into sets: their BDD prime cover\n \
+\t is improved by the espresso heuristic, so the result is not guaranteed to be minimal)\n \
 -s\t if the function in the file is represented by a set of sets on which it is equal to the truth\n \
--v\t if the function in the file is represented by a vector of values\n \
+\t (sets after d up to the end of the line are don't-cares, e.g. 1 4 10 d 2 3)\n \
+-v\t if the function in the file is represented by a vector of values (- for don't-care)\n \
 output_mode can take one of the following values: \n \
 -f\t for representation by the formula\n \
--s\t for representation by symbols -, 1 and 0 for lack of x, x and not x in the disjuncts\n";
+-s\t for representation by symbols -, 1 and 0 for lack of x, x and not x in the disjuncts\n \
+Functions of at most 64 variables are supported with -f and -v. With -s set numbers may take\n \
+\t up to 128 bits: functions of more than 64 variables are minimized by the espresso heuristic\n \
+\t (the result is not guaranteed to be minimal) and are not cached.\n \
+-stats\t print phase durations and counters of the minimization to the console\n \
+-cache\t reuse results stored in cache_file for the same function and store new ones there\n";
 		}
 	}
-	else if (argc == 5) {
+	else if (argc >= 5) {
+		auto print_stats = false;
+		std::string cache_file;
+		for (int i = 5; i < argc; ++i) {
+			if (std::string(argv[i]) == "-stats")
+				print_stats = true;
+			else if (std::string(argv[i]) == "-cache" && i + 1 < argc)
+				cache_file = argv[++i];
+			else
+				throw std::logic_error("Invalid flags. Please see the help with -h or -help.");
+		}
 		if (!((std::string(argv[1]) == "-f" ||
 			std::string(argv[1]) == "-s" ||
 			std::string(argv[1]) == "-v") &&
@@ -30,24 +50,45 @@ output_mode can take one of the following values: \n \
 		std::ofstream output_file(argv[4]);
 		if (!(input_file.is_open() || output_file.is_open()))
 			throw std::logic_error("Can not open files. Please check your files and try again.");
-		std::stringstream ss;
 		std::string input_string;
 		Quine_McCluskey_Simplifier QMS;
+		simplify_options options;
 
 		if (std::string(argv[1]) == "-f") {
 			std::getline(input_file, input_string);
 			log_expr le(input_string);
-			le.print(ss);
-			QMS.init(ss, false);
+			// Единицы выписываются по диаграмме решений, без перебора всех наборов
+			bdd manager(le.variables());
+			const auto f = le.to_bdd(manager);
+			if (le.variables() < 64 && manager.count(f) <= (1 << 20))
+				QMS.init(manager.minterms(f), std::vector<std::uint64_t>(), le.variables());
+			else {
+				// Наборов слишком много, чтобы их выписывать (или номер набора 64 переменных
+				// не помещается в bdd::minterms): покрытие строится по диаграмме
+				QMS.init_cubes(manager.prime_cover(f), le.variables());
+				options.engine = e_espresso;
+			}
 		}
 		else if (std::string(argv[1]) == "-s") {
-			QMS.init(input_file, true);
+			QMS.init(std::string(argv[3]), true);
 		}
 		else if (std::string(argv[1]) == "-v") {
-			QMS.init(input_file, false);
+			QMS.init(std::string(argv[3]), false);
 		}
 		input_file.close();
-		QMS.simplify();
+		// Все наборы функции больше чем от 64 переменных не перебрать: только эвристика
+		const auto wide = QMS.variables() > cube::max_vars;
+		if (wide)
+			options.engine = e_espresso;
+		simplify_stats stats;
+		if (print_stats)
+			options.stats = &stats;
+		std::unique_ptr<result_cache> cache;
+		if (!cache_file.empty() && !wide) {
+			cache.reset(new result_cache(cache_file));
+			options.cache = cache.get();
+		}
+		QMS.simplify(options);
 
 		if (std::string(argv[2]) == "-f") {
 			QMS.print_formula(output_file);
@@ -56,6 +97,8 @@ output_mode can take one of the following values: \n \
 			QMS.print_mdnf(output_file);
 		}
 		output_file.close();
+		if (print_stats)
+			stats.print(std::cout);
 		std::cout << "Done." << std::endl;
 	}
 	else {